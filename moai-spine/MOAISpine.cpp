@@ -4,10 +4,174 @@
 #include "pch.h"
 #include <moai-spine/MOAISpine.h>
 
+//================================================================//
+// MOAISpineLod
+//================================================================//
+
+//----------------------------------------------------------------//
+MOAISpineLod::MOAISpineLod () :
+	mInterval ( 1 ),
+	mMode ( MOAISpine::LOD_HOLD ),
+	mTimelineMask ( TIMELINE_MASK_ALL ),
+	mMaxSize ( 0.0f ) {
+}
+
+//================================================================//
+// MOAISpineStats
+//================================================================//
+
+//----------------------------------------------------------------//
+MOAISpineStats::MOAISpineStats () {
+	this->Reset ();
+}
+
+//----------------------------------------------------------------//
+void MOAISpineStats::Reset () {
+	mEventsFired = 0;
+	mMaxEventsFired = 0;
+	mSkeletonsCulled = 0;
+	mSkeletonsInstanced = 0;
+	mRunsDrawn = 0;
+	mDraws = 0;
+	mDrawTime = 0.0;
+	mStateChanges = 0;
+	mStateChangesSkipped = 0;
+	mSlotsSkipped = 0;
+	mPosesUpdated = 0;
+	mPosesReused = 0;
+	mBatchTexture = 0;
+	mBatchShader = 0;
+	mBatchAdditive = false;
+}
+
 //================================================================//
 // lua
 //================================================================//
 
+//----------------------------------------------------------------//
+/**	@name	addViewRect
+	@text	Registers a world space rectangle, usually what a camera
+			sees, for skeletons with a culling update policy. Skeletons
+			whose bounds overlap no registered rectangle are culled.
+			With no rectangles only invisible skeletons are culled.
+ 
+	@in		number	xMin
+	@in		number	yMin
+	@in		number	xMax
+	@in		number	yMax
+	@out	nil
+*/
+int MOAISpine::_addViewRect ( lua_State* L ) {
+	
+	MOAILuaState state ( L );
+	if ( !state.CheckParams ( 1, "NNNN" )) return 0;
+	
+	ZLRect rect;
+	rect.Init (
+		state.GetValue < float >( 1, 0.0f ),
+		state.GetValue < float >( 2, 0.0f ),
+		state.GetValue < float >( 3, 0.0f ),
+		state.GetValue < float >( 4, 0.0f )
+	);
+	rect.Bless ();
+	MOAISpine::Get ().mViewRects.Push ( rect );
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	clearViewRects
+	@text	Removes the rectangles registered with addViewRect.
+ 
+	@out	nil
+*/
+int MOAISpine::_clearViewRects ( lua_State* L ) {
+	UNUSED ( L );
+	
+	MOAISpine::Get ().mViewRects.Reset ();
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	getStats
+	@text	Returns counters gathered since the last call to resetStats.
+			Call resetStats once a frame to read them per frame.
+ 
+	@out	table	stats		eventsFired: spine events fired by all
+								skeletons; maxEventsFired: most events
+								fired by one skeleton in one update;
+								skeletonsCulled: updates that skipped
+								posing because the skeleton was culled;
+								skeletonsInstanced: updates that reused
+								a master's pose; runsDrawn: runs of
+								quads sharing texture and blend mode;
+								draws: an estimate of the device draws,
+								counting runs that changed the render
+								state from the run before; props of
+								other types drawn in between also
+								break batches but aren't counted, so
+								it can read low;
+								drawTime: seconds spent drawing
+								skeletons; stateChanges and
+								stateChangesSkipped: texture and blend
+								mode changes issued and skipped as
+								redundant; slotsSkipped: hidden slots
+								left out of vertex generation and
+								transparent slots left out of drawing;
+								posesUpdated and posesReused: skeleton
+								updates that recomputed world
+								transforms and vertices, and those that
+								found the pose unchanged and kept them
+*/
+int MOAISpine::_getStats ( lua_State* L ) {
+	
+	MOAILuaState state ( L );
+	MOAISpineStats& stats = MOAISpine::Get ().GetStats ();
+	
+	lua_newtable ( state );
+	state.SetField ( -1, "eventsFired", stats.mEventsFired );
+	state.SetField ( -1, "maxEventsFired", stats.mMaxEventsFired );
+	state.SetField ( -1, "skeletonsCulled", stats.mSkeletonsCulled );
+	state.SetField ( -1, "skeletonsInstanced", stats.mSkeletonsInstanced );
+	state.SetField ( -1, "runsDrawn", stats.mRunsDrawn );
+	state.SetField ( -1, "draws", stats.mDraws );
+	state.SetField ( -1, "drawTime", stats.mDrawTime );
+	state.SetField ( -1, "stateChanges", stats.mStateChanges );
+	state.SetField ( -1, "stateChangesSkipped", stats.mStateChangesSkipped );
+	state.SetField ( -1, "slotsSkipped", stats.mSlotsSkipped );
+	state.SetField ( -1, "posesUpdated", stats.mPosesUpdated );
+	state.SetField ( -1, "posesReused", stats.mPosesReused );
+	return 1;
+}
+
+//----------------------------------------------------------------//
+/**	@name	resetStats
+	@text	Zeroes the counters returned by getStats.
+ 
+	@out	nil
+*/
+int MOAISpine::_resetStats ( lua_State* L ) {
+	UNUSED ( L );
+	
+	MOAISpine::Get ().GetStats ().Reset ();
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setBatching
+	@text	Draws skeletons with their vertices transformed to world
+			space on the CPU. Consecutive skeletons in the render list
+			that share texture, blend mode and shader then leave the
+			device state untouched, and the device draws them together.
+ 
+	@opt	bool	enabled		Default value is true.
+	@out	nil
+*/
+int MOAISpine::_setBatching ( lua_State* L ) {
+	MOAILuaState state ( L );
+	
+	MOAISpine::Get ().mBatching = state.GetValue < bool >( 1, true );
+	return 0;
+}
 
 //----------------------------------------------------------------//
 /**	@name	setCreateTexture
@@ -28,6 +192,51 @@ int MOAISpine::_setCreateTexture ( lua_State* L ) {
 }
 
 
+//----------------------------------------------------------------//
+/**	@name	setLod
+	@text	Defines a level of detail for skeletons. Level 0 always
+			poses every update; higher levels pose every Nth update and
+			only fire events in between. Skeletons pick a level with
+			setLodLevel, or from their size against the rectangles
+			registered with addViewRect. Skeletons posing at the same
+			interval are spread evenly over the updates.
+ 
+	@in		number	level		1 or more
+	@opt	number	interval	pose every Nth update. Default value is 2.
+	@opt	number	mode		between posing updates, LOD_HOLD keeps the
+								last pose, LOD_EXTRAPOLATE continues the
+								motion of the last two poses and
+								LOD_INTERPOLATE blends between them, one
+								interval late. Default value is LOD_HOLD.
+	@opt	boolean	skipColor	skip slot color timelines. Default value is false.
+	@opt	number	maxSize		picked automatically for skeletons smaller
+								than this fraction of the view. Default
+								value is 0, never picked automatically.
+	@out	nil
+*/
+int MOAISpine::_setLod ( lua_State* L ) {
+	
+	MOAILuaState state ( L );
+	if ( !state.CheckParams ( 1, "N" )) return 0;
+	
+	u32 level = state.GetValue < u32 >( 1, 1 );
+	if ( level < 1 ) return 0;
+	
+	ZLLeanArray < MOAISpineLod >& lods = MOAISpine::Get ().mLods;
+	lods.Grow ( level + 1 );
+	
+	MOAISpineLod& lod = lods [ level ];
+	lod.mInterval = state.GetValue < u32 >( 2, 2 );
+	lod.mMode = state.GetValue < u32 >( 3, LOD_HOLD );
+	lod.mTimelineMask = state.GetValue < bool >( 4, false ) ? TIMELINE_MASK_ALL & ~( 1 << TIMELINE_COLOR ) : TIMELINE_MASK_ALL;
+	lod.mMaxSize = state.GetValue < float >( 5, 0.0f );
+	
+	if ( lod.mInterval < 1 ) {
+		lod.mInterval = 1;
+	}
+	return 0;
+}
+
 //----------------------------------------------------------------//
 /**	@name	setReadFile
 	@text	When spine needs to load a file it will call this function
@@ -53,11 +262,67 @@ int MOAISpine::_setReadFile ( lua_State* L ) {
 //================================================================//
 
 //----------------------------------------------------------------//
-MOAISpine::MOAISpine () {
+void MOAISpine::CountRun ( MOAITexture* texture, bool additive, MOAIShader* shader, bool transformed ) {
+	
+	mStats.mRunsDrawn++;
+	
+	// the first run after a reset always counts, so resetting once a frame counts each frame's first draw
+	if ( transformed || ( texture != mStats.mBatchTexture ) || ( additive != mStats.mBatchAdditive ) || ( shader != mStats.mBatchShader )) {
+		mStats.mDraws++;
+		mStats.mBatchTexture = texture;
+		mStats.mBatchAdditive = additive;
+		mStats.mBatchShader = shader;
+	}
+}
+
+//----------------------------------------------------------------//
+const MOAIBlendMode& MOAISpine::GetBlendMode ( bool additive ) {
+	
+	return additive ? mAdditiveBlend : mNormalBlend;
+}
+
+//----------------------------------------------------------------//
+const MOAISpineLod& MOAISpine::GetLod ( u32 level ) {
+	
+	if ( level >= mLods.Size ()) {
+		level = mLods.Size () - 1;
+	}
+	return mLods [ level ];
+}
+
+//----------------------------------------------------------------//
+bool MOAISpine::IsCulled ( const ZLBox& bounds ) {
+	
+	u32 count = mViewRects.GetTop ();
+	if ( !count ) {
+		return false;
+	}
+	
+	for ( u32 i = 0; i < count; ++i ) {
+		ZLRect& rect = mViewRects [ i ];
+		if (( bounds.mMax.mX >= rect.mXMin ) && ( bounds.mMin.mX <= rect.mXMax ) &&
+			( bounds.mMax.mY >= rect.mYMin ) && ( bounds.mMin.mY <= rect.mYMax )) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------//
+MOAISpine::MOAISpine () :
+	mListener ( 0 ),
+	mBatching ( false ) {
+	
 	RTTI_BEGIN
 		RTTI_EXTEND ( MOAILuaObject )
 		
 	RTTI_END
+	
+	mLods.Init ( 1 );
+	
+	// atlas pages are premultiplied: BLEND_ADD would scale the texel by its alpha a second time
+	mNormalBlend.SetBlend ( MOAIBlendMode::BLEND_NORMAL );
+	mAdditiveBlend.SetBlend ( ZGL_BLEND_FACTOR_ONE, ZGL_BLEND_FACTOR_ONE );
 }
 
 //----------------------------------------------------------------//
@@ -67,12 +332,50 @@ MOAISpine::~MOAISpine () {
 //----------------------------------------------------------------//
 void MOAISpine::RegisterLuaClass ( MOAILuaState& state ) {
 
+	state.SetField ( -1, "LOD_HOLD", ( u32 )LOD_HOLD );
+	state.SetField ( -1, "LOD_EXTRAPOLATE", ( u32 )LOD_EXTRAPOLATE );
+	state.SetField ( -1, "LOD_INTERPOLATE", ( u32 )LOD_INTERPOLATE );
+
 	// here are the class methods:
 	luaL_Reg regTable [] = {
+		{ "addViewRect",			_addViewRect },
+		{ "clearViewRects",			_clearViewRects },
+		{ "getStats",				_getStats },
+		{ "resetStats",				_resetStats },
+		{ "setBatching",			_setBatching },
 		{ "setCreateTexture",		_setCreateTexture },
+		{ "setLod",					_setLod },
 		{ "setReadFile",			_setReadFile },
 		{ NULL, NULL }
 	};
 
 	luaL_register ( state, 0, regTable );
 }
+
+//----------------------------------------------------------------//
+u32 MOAISpine::SelectLod ( const ZLBox& bounds ) {
+	
+	float view = 0.0f;
+	for ( u32 i = 0; i < mViewRects.GetTop (); ++i ) {
+		ZLRect& rect = mViewRects [ i ];
+		float width = rect.mXMax - rect.mXMin;
+		float height = rect.mYMax - rect.mYMin;
+		view = width > view ? width : view;
+		view = height > view ? height : view;
+	}
+	if ( view <= 0.0f ) {
+		return 0;
+	}
+	
+	float width = bounds.mMax.mX - bounds.mMin.mX;
+	float height = bounds.mMax.mY - bounds.mMin.mY;
+	float size = ( width > height ? width : height ) / view;
+	
+	// the coarsest level the skeleton is small enough for
+	for ( u32 i = mLods.Size () - 1; i > 0; --i ) {
+		if ( size < mLods [ i ].mMaxSize ) {
+			return i;
+		}
+	}
+	return 0;
+}
@@ -6,6 +6,52 @@
 
 #include <spine/spine.h>
 
+class MOAISpineListener;
+
+//================================================================//
+// MOAISpineStats
+//================================================================//
+class MOAISpineStats {
+public:
+
+	u32		mEventsFired;		// spine events fired since the last reset
+	u32		mMaxEventsFired;	// most events fired by one skeleton in one update
+	u32		mSkeletonsCulled;	// skeleton updates that skipped posing or were paused
+	u32		mSkeletonsInstanced;	// skeleton updates that drew a master's pose
+	u32		mRunsDrawn;			// runs of quads sharing texture and blend mode
+	u32		mDraws;				// estimated device draws: runs that changed the texture, blend mode, shader or transform
+	double	mDrawTime;			// seconds spent in skeleton Draw
+	u32		mStateChanges;		// texture and blend mode changes issued by Draw
+	u32		mStateChangesSkipped;	// changes Draw skipped because the state already matched
+	u32		mSlotsSkipped;		// hidden and transparent region slots left out, counted on every Draw
+	u32		mPosesUpdated;		// skeleton updates that recomputed world transforms or vertices
+	u32		mPosesReused;		// skeleton updates that found the pose unchanged and kept them
+	
+	// state of the last run counted, cleared with the counters; other props drawn in between aren't seen
+	MOAITexture*	mBatchTexture;
+	MOAIShader*		mBatchShader;
+	bool			mBatchAdditive;
+
+	//----------------------------------------------------------------//
+	void	Reset				();
+			MOAISpineStats		();
+};
+
+//================================================================//
+// MOAISpineLod
+//================================================================//
+class MOAISpineLod {
+public:
+
+	u32		mInterval;			// pose every Nth update
+	u32		mMode;				// how the pose moves between posing updates
+	int		mTimelineMask;		// timelines applied when posing
+	float	mMaxSize;			// picked automatically below this fraction of the view
+
+	//----------------------------------------------------------------//
+			MOAISpineLod		();
+};
+
 //================================================================//
 // MOAISpine
 //================================================================//
@@ -20,23 +66,55 @@ private:
 	
 	MOAILuaStrongRef mReadFileRef;
 	MOAILuaStrongRef mCreateTextureRef;
+	MOAISpineStats	mStats;
+	MOAISpineListener* mListener;
+	
+	ZLLeanStack < ZLRect > mViewRects;
+	ZLLeanArray < MOAISpineLod > mLods;
+	
+	bool			mBatching;
+	
+	MOAIBlendMode	mNormalBlend;
+	MOAIBlendMode	mAdditiveBlend;
 	
 	//----------------------------------------------------------------//
+	static int		_addViewRect		( lua_State* L );
+	static int		_clearViewRects		( lua_State* L );
+	static int		_getStats			( lua_State* L );
+	static int		_resetStats			( lua_State* L );
+	static int		_setBatching		( lua_State* L );
 	static int		_setCreateTexture	( lua_State* L );
+	static int		_setLod				( lua_State* L );
 	static int		_setReadFile		( lua_State* L );
 	
 public:
 	
 	DECL_LUA_SINGLETON ( MOAISpine )
+	
+	enum {
+		LOD_HOLD,
+		LOD_EXTRAPOLATE,
+		LOD_INTERPOLATE,
+	};
 		
 	GET ( MOAILuaStrongRef&, ReadFileRef, mReadFileRef )
 	GET ( MOAILuaStrongRef&, CreateTextureRef, mCreateTextureRef )
+	GET ( MOAISpineStats&, Stats, mStats )
+	GET ( bool, Batching, mBatching )
+	
+	// receives the animation events of every skeleton
+	GET_SET ( MOAISpineListener*, NativeListener, mListener )
 	
 
 	//----------------------------------------------------------------//
+	void			CountRun			( MOAITexture* texture, bool additive, MOAIShader* shader, bool transformed );
+	const MOAIBlendMode&	GetBlendMode	( bool additive );
+	const MOAISpineLod&	GetLod			( u32 level );
+	bool			IsCulled			( const ZLBox& bounds );
 					MOAISpine			();
 					~MOAISpine			();
 	void			RegisterLuaClass	( MOAILuaState& state );
+	u32				SelectLod			( const ZLBox& bounds );
 };
 
 #endif
@@ -51,6 +51,7 @@ bool MOAISpineBone::ApplyAttrOp ( u32 attrID, MOAIAttrOp& attrOp, u32 op ) {
 				if ( mLockFlags & LOCK_LOC ) break;
 				mBone->x = attrOp.Apply ( mBone->x, op, MOAIAttrOp::ATTR_READ_WRITE );
 				spBone_updateWorldTransform ( mBone, mFlipX, mFlipY );
+				mWorldDirty = true;
 				return true;
 			}
 				
@@ -58,6 +59,7 @@ bool MOAISpineBone::ApplyAttrOp ( u32 attrID, MOAIAttrOp& attrOp, u32 op ) {
 				if ( mLockFlags & LOCK_LOC ) break;
 				mBone->y = attrOp.Apply ( mBone->y, op, MOAIAttrOp::ATTR_READ_WRITE );
 				spBone_updateWorldTransform ( mBone, mFlipX, mFlipY );
+				mWorldDirty = true;
 				return true;
 			}
 			
@@ -65,6 +67,7 @@ bool MOAISpineBone::ApplyAttrOp ( u32 attrID, MOAIAttrOp& attrOp, u32 op ) {
 				if ( mLockFlags & LOCK_ROT ) break;
 				mBone->rotation = attrOp.Apply ( mBone->rotation, op, MOAIAttrOp::ATTR_READ_WRITE );
 				spBone_updateWorldTransform ( mBone, mFlipX, mFlipY );
+				mWorldDirty = true;
 				return true;
 			}
 				
@@ -72,6 +75,7 @@ bool MOAISpineBone::ApplyAttrOp ( u32 attrID, MOAIAttrOp& attrOp, u32 op ) {
 				if ( mLockFlags & LOCK_SCL ) break;
 				mBone->scaleX = attrOp.Apply ( mBone->scaleX, op, MOAIAttrOp::ATTR_READ_WRITE );
 				spBone_updateWorldTransform ( mBone, mFlipX, mFlipY );
+				mWorldDirty = true;
 				return true;
 			}
 				
@@ -79,6 +83,7 @@ bool MOAISpineBone::ApplyAttrOp ( u32 attrID, MOAIAttrOp& attrOp, u32 op ) {
 				if ( mLockFlags & LOCK_SCL ) break;
 				mBone->scaleY = attrOp.Apply ( mBone->scaleY, op, MOAIAttrOp::ATTR_READ_WRITE );
 				spBone_updateWorldTransform ( mBone, mFlipX, mFlipY );
+				mWorldDirty = true;
 				return true;
 			}
 		}
@@ -114,6 +119,7 @@ MOAISpineBone::MOAISpineBone ():
 	mBone ( 0 ),
 	mRootTransform ( 0 ),
 	mLockFlags ( 0 ),
+	mWorldDirty ( false ),
 	mFlipX ( false ),
 	mFlipY ( false ) {
 	RTTI_BEGIN
@@ -131,19 +137,26 @@ void MOAISpineBone::OnDepNodeUpdate () {
 		
 	if ( mBone ) {
 		
+		// a lock that rewrites the values the bone already has leaves the skeleton's pose unchanged
+		bool changed = false;
+		
 		if ( mLockFlags & LOCK_LOC ) {
+			changed = changed || ( mBone->x != mLoc.mX ) || ( mBone->y != mLoc.mY );
 			mBone->x = mLoc.mX;
 			mBone->y = mLoc.mY;
 		}
 		if ( mLockFlags & LOCK_ROT ) {
+			changed = changed || ( mBone->rotation != mRot.mZ );
 			mBone->rotation = mRot.mZ;
 		}
 		if ( mLockFlags & LOCK_SCL ) {
+			changed = changed || ( mBone->scaleX != mScale.mX ) || ( mBone->scaleY != mScale.mY );
 			mBone->scaleX = mScale.mX;
 			mBone->scaleY = mScale.mY;
 		}
 		if ( mLockFlags ) {
 			spBone_updateWorldTransform ( mBone, mFlipX, mFlipY );
+			mWorldDirty = mWorldDirty || changed;
 		}
 		
 		float parentRot = 0.0f;
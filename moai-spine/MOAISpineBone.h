@@ -22,6 +22,7 @@ private:
 	spBone* mBone;
 	MOAITransform* mRootTransform;
 	u32 mLockFlags;
+	bool mWorldDirty;	// world transform recomputed here, without the skeleton's pass
 	
 	//----------------------------------------------------------------//
 	static int		_clearLock		( lua_State* L );
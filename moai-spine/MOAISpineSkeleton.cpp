@@ -4,6 +4,7 @@
 #include "pch.h"
 #include <float.h>
 #include <moai-spine/MOAISpineSkeleton.h>
+#include <moai-spine/MOAISpine.h>
 #include <moai-spine/MOAISpineBone.h>
 #include <moai-spine/MOAISpineSkeletonData.h>
 #include <moai-spine/MOAISpineSlot.h>
@@ -15,6 +16,20 @@ static void callback (spAnimationState* state, int trackIndex, spEventType type,
 	((MOAISpineSkeleton*) state->context )->OnAnimationEvent ( trackIndex, type, event, loopCount );
 }
 
+//================================================================//
+// Spine baked animation mixer
+//================================================================//
+static void bakedMixer (spAnimationState* state, spAnimation* animation, spSkeleton* skeleton, float lastTime, float time,
+		int loop, spEvent** events, int* eventCount, float alpha) {
+	((MOAISpineSkeleton*) state->context )->MixBakedAnimation ( animation, skeleton, lastTime, time, loop, events, eventCount, alpha );
+}
+
+//================================================================//
+// Spine level of detail
+//================================================================//
+// consecutive counters give skeletons at the same interval different posing updates
+static u32 sLodCounter = 0;
+
 //================================================================//
 // lua
 //================================================================//
@@ -38,6 +53,8 @@ int MOAISpineSkeleton::_addAnimation ( lua_State *L ) {
 	bool loop = state.GetValue < bool >( 4, false );
 	float delay = state.GetValue < float >( 5, 0.f );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton || !self->mAnimationState ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -55,6 +72,8 @@ int MOAISpineSkeleton::_addAnimation ( lua_State *L ) {
 int MOAISpineSkeleton::_clearAllTracks ( lua_State *L ) {
 	MOAI_LUA_SETUP( MOAISpineSkeleton, "U" )
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton || !self->mAnimationState ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -75,6 +94,8 @@ int MOAISpineSkeleton::_clearTrack ( lua_State *L ) {
 	
 	int trackId = state.GetValue < int >( 2, 0);
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton || !self->mAnimationState ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -99,6 +120,8 @@ int MOAISpineSkeleton::_getBone ( lua_State *L ) {
 	
 	cc8* boneName = state.GetValue < cc8* >( 2, 0 );
 	
+	self->ForkInstance ();
+	
 	spBone* bone = spSkeleton_findBone ( self->mSkeleton, boneName );
 	if ( !bone ) {
 		return 0;
@@ -109,6 +132,21 @@ int MOAISpineSkeleton::_getBone ( lua_State *L ) {
 	return 1;
 }
 
+//----------------------------------------------------------------//
+/**	@name	getEventsFired
+	@text	Returns the number of spine events fired during the last
+			update.
+
+ 	@in		MOAISpineSkeleton self
+	@out	number	count
+*/
+int MOAISpineSkeleton::_getEventsFired ( lua_State *L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	state.Push ( self->mEventsFired );
+	return 1;
+}
+
 //----------------------------------------------------------------//
 /**	@name	getSlot
 	@text	Return MOAIColor that is bound to skeleton slot.
@@ -123,6 +161,8 @@ int MOAISpineSkeleton::_getSlot ( lua_State *L ) {
 	
 	cc8* slotName = state.GetValue < cc8* >( 2, 0 );
 	
+	self->ForkInstance ();
+	
 	spSlot* slot = spSkeleton_findSlot ( self->mSkeleton, slotName );
 	if ( !slot ) {
 		return 0;
@@ -159,6 +199,7 @@ int MOAISpineSkeleton::_init ( lua_State* L ) {
 		MOAIPrint ( "Empty skeleton data \n" );
 		return 0;
 	}
+	self->mMaster.Set ( *self, 0 );
 	self->mSkeletonData.Set ( *self, data );
 	self->Init ( data->mSkeletonData );
 	
@@ -167,6 +208,10 @@ int MOAISpineSkeleton::_init ( lua_State* L ) {
 
 //----------------------------------------------------------------//
 /**	@name	initAnimationState
+	@text	Creates the animation state. Mixes come from the skeleton
+			data and are shared with every skeleton created from it;
+			mixes set on this skeleton override them for it alone.
+			Does nothing if the skeleton already has an animation state.
 
 	@in		MOAISpineSkeleton self
 	@out	nil
@@ -174,13 +219,14 @@ int MOAISpineSkeleton::_init ( lua_State* L ) {
 int MOAISpineSkeleton::_initAnimationState ( lua_State *L ) {
 	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
 	}
-	spAnimationStateData* data = spAnimationStateData_create ( self->mSkeleton->data );
-	self->InitAnimationState ( data );
 	
+	self->AffirmAnimationState ();
 	return 0;
 }
 
@@ -202,6 +248,8 @@ int MOAISpineSkeleton::_setAnimation ( lua_State *L ) {
 	bool loop = state.GetValue < bool >( 4, false );
 	float delay = state.GetValue < float >( 5, 0.0f );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton || !self->mAnimationState ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -224,15 +272,41 @@ int MOAISpineSkeleton::_setAttachment ( lua_State* L ) {
 	cc8* slotName = state.GetValue < cc8* >( 2, 0 );
 	cc8* attachmentName = state.GetValue < cc8* >( 3, 0 );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		state.Push ( false );
 		return 1;
 	}
 	state.Push ( (bool) spSkeleton_setAttachment ( self->mSkeleton, slotName, attachmentName ));
+	self->UpdateSkeleton ();
+	self->ScheduleUpdate ();
 	return 1;
 }
 
+//----------------------------------------------------------------//
+/**	@name	setBakedPlayback
+	@text	Plays animations from data sampled at a fixed rate (see
+			MOAISpineSkeletonData.bakeAnimations) instead of evaluating
+			timeline curves. Trades memory and some precision for
+			cheaper updates.
+
+	@in		MOAISpineSkeleton self
+	@opt	bool	enabled		Default value is true.
+	@out	nil
+*/
+int MOAISpineSkeleton::_setBakedPlayback ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	self->mBakedPlayback = state.GetValue < bool >( 2, true );
+	
+	if ( self->mAnimationState ) {
+		self->mAnimationState->mixer = self->mBakedPlayback ? bakedMixer : 0;
+	}
+	return 0;
+}
+
 //----------------------------------------------------------------//
 /**	@name	setBonesToSetupPose
 
@@ -242,6 +316,8 @@ int MOAISpineSkeleton::_setAttachment ( lua_State* L ) {
 int MOAISpineSkeleton::_setBonesToSetupPose	( lua_State* L ) {
 	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -251,6 +327,85 @@ int MOAISpineSkeleton::_setBonesToSetupPose	( lua_State* L ) {
 	return 0;
 }
 
+//----------------------------------------------------------------//
+/**	@name	setEventBatching
+	@text	Queues animation events during an update and delivers them
+			afterwards in a single call to the EVENT_ANIMATION_BATCH
+			listener, instead of calling a listener per event. The
+			listener receives an array of tables with the fields type
+			(one of the EVENT_ANIMATION_* constants), track, and either
+			loopCount or name, int, float and string.
+
+	@in		MOAISpineSkeleton self
+	@in		boolean	batching
+	@out	nil
+*/
+int MOAISpineSkeleton::_setEventBatching ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "UB" )
+	
+	self->mEventBatching = state.GetValue < bool >( 2, false );
+	if ( !self->mEventBatching ) {
+		self->mEventQueue.Reset ();
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setEventMask
+	@text	Limits the animation events delivered to Lua to the given
+			types. Events of other types are dropped without touching
+			the Lua state. With no types, every event is delivered.
+
+	@in		MOAISpineSkeleton self
+	@opt	number	type		any number of EVENT_ANIMATION_START,
+								EVENT_ANIMATION_END, EVENT_ANIMATION_COMPLETE
+								and EVENT_ANIMATION_EVENT
+	@out	nil
+*/
+int MOAISpineSkeleton::_setEventMask ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	int top = state.GetTop ();
+	if ( top < 2 ) {
+		self->mEventMask = 0xffffffff;
+		return 0;
+	}
+	
+	self->mEventMask = 0;
+	for ( int i = 2; i <= top; ++i ) {
+		u32 eventID = state.GetValue < u32 >( i, 0 );
+		if (( eventID >= EVENT_ANIMATION_START ) && ( eventID <= EVENT_ANIMATION_EVENT )) {
+			self->mEventMask |= 1 << ( eventID - EVENT_ANIMATION_START );
+		}
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setFixedStep
+	@text	Advances the animation in fixed steps, whatever the frame
+			rate, so the same total time always gives the same poses
+			and events. The drawn pose is interpolated between the last
+			two steps and so lags by up to one step. Level of detail
+			intervals don't apply in this mode.
+
+	@in		MOAISpineSkeleton self
+	@opt	number	step		Seconds per step. Default value is 0,
+								which advances by the action's step.
+	@out	nil
+*/
+int MOAISpineSkeleton::_setFixedStep ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	self->mFixedStep = state.GetValue < float >( 2, 0.0f );
+	
+	if ( self->mFixedSteps ) {
+		spFixedStep_dispose ( self->mFixedSteps );
+		self->mFixedSteps = 0;
+	}
+	return 0;
+}
+
 //----------------------------------------------------------------//
 /**	@name	setFlip
  
@@ -265,6 +420,8 @@ int MOAISpineSkeleton::_setFlip ( lua_State *L ) {
 	bool flipX = state.GetValue < bool >( 2, false );
 	bool flipY = state.GetValue < bool >( 3, false );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -281,8 +438,106 @@ int MOAISpineSkeleton::_setFlip ( lua_State *L ) {
 	return 0;
 }
 
+//----------------------------------------------------------------//
+/**	@name	setInstanceOf
+	@text	Makes this skeleton an instance of another skeleton made
+			from the same data. The instance skips its own animation
+			and posing and draws the master's pose with its own
+			transform and color. Changing the instance's animation or
+			pose (setAnimation, setAttachment, getBone and the like)
+			forks it: it takes over the master's current pose and
+			tracks and animates on its own from then on. Instances
+			fire no animation events; the master should use
+			UPDATE_ALWAYS if it is kept hidden.
+
+	@in		MOAISpineSkeleton self
+	@opt	MOAISpineSkeleton master	Default value is nil, which forks
+										the instance.
+	@out	nil
+*/
+int MOAISpineSkeleton::_setInstanceOf ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	MOAISpineSkeleton* master = state.GetLuaObject < MOAISpineSkeleton >( 2, true );
+	
+	if ( !self->mSkeleton ) {
+		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
+		return 0;
+	}
+	
+	if ( !master ) {
+		self->ForkInstance ();
+		return 0;
+	}
+	
+	// instances of instances follow the same master
+	master = master->GetPoseSource ();
+	if ( master == self ) {
+		return 0;
+	}
+	
+	if ( !master->mSkeleton || master->mSkeleton->data != self->mSkeleton->data ) {
+		MOAIPrint ( "MOAISpineSkeleton instance needs the master's skeleton data \n" );
+		return 0;
+	}
+	
+	// bones and slots follow this skeleton's own pose
+	if ( self->mBoneTransformMap.size () || self->mSlotColorMap.size ()) {
+		MOAIPrint ( "MOAISpineSkeleton with bones or slots can't be an instance \n" );
+		return 0;
+	}
+	
+	self->mMaster.Set ( *self, master );
+	self->ScheduleUpdate ();
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setListener
+	@text	Same as MOAIInstanceEventSource's setListener. Animation
+			events without a Lua listener are then never marshalled.
+
+	@in		MOAISpineSkeleton self
+	@in		number	eventID
+	@opt	function	callback
+	@out	nil
+*/
+int MOAISpineSkeleton::_setListener ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "UN" )
+	
+	u32 eventID = state.GetValue < u32 >( 2, 0 );
+	if (( eventID >= EVENT_ANIMATION_START ) && ( eventID <= EVENT_ANIMATION_BATCH )) {
+		u32 bit = 1 << ( eventID - EVENT_ANIMATION_START );
+		if ( state.IsType ( 3, LUA_TFUNCTION )) {
+			self->mLuaListenerMask |= bit;
+		}
+		else {
+			self->mLuaListenerMask &= ~bit;
+		}
+	}
+	return MOAIInstanceEventSource::_setListener ( L );
+}
+
+//----------------------------------------------------------------//
+/**	@name	setLodLevel
+	@text	Uses one of the levels of detail defined with MOAISpine.setLod.
+			Level 0, the default, poses every update.
+
+	@in		MOAISpineSkeleton self
+	@opt	number	level		with no level, it is picked from the
+								skeleton's size in the view
+	@out	nil
+*/
+int MOAISpineSkeleton::_setLodLevel ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	self->mLodLevel = state.IsType ( 2, LUA_TNUMBER ) ? state.GetValue < int >( 2, 0 ) : -1;
+	return 0;
+}
+
 //----------------------------------------------------------------//
 /**	@name	setMix
+	@text	Overrides a shared mix duration for this skeleton only.
  
  	@in		MOAISpineSkeleton self
 	@in		string	from
@@ -297,6 +552,8 @@ int MOAISpineSkeleton::_setMix ( lua_State *L ) {
 	cc8* toName   = state.GetValue < cc8* >( 3, "" );
 	float duration  = state.GetValue < float >( 4, 0.1 );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton || !self->mAnimationState ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -306,6 +563,60 @@ int MOAISpineSkeleton::_setMix ( lua_State *L ) {
 	return 0;
 }
 
+//----------------------------------------------------------------//
+/**	@name	setMixes
+	@text	Overrides many shared mix durations at once for this
+			skeleton only.
+
+	@in		MOAISpineSkeleton self
+	@in		table	mixes		array of { fromName, toName, duration }
+	@out	nil
+*/
+int MOAISpineSkeleton::_setMixes ( lua_State *L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "UT" );
+	
+	self->ForkInstance ();
+	
+	if ( !self->mSkeleton || !self->mAnimationState ) {
+		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
+		return 0;
+	}
+	
+	u32 count = state.GetTableSize ( 2 );
+	for ( u32 i = 1; i <= count; ++i ) {
+		lua_rawgeti ( state, 2, i );
+		cc8* fromName = state.GetField < cc8* >( -1, 1, "" );
+		cc8* toName = state.GetField < cc8* >( -1, 2, "" );
+		float duration = state.GetField < float >( -1, 3, 0.1f );
+		self->SetMix ( fromName, toName, duration );
+		state.Pop ( 1 );
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setPoseBlending
+	@text	Starting an animation during a mix chains the mixes instead
+			of dropping the animation being mixed out. Chains are blended
+			by sampling each animation into a pose buffer; a mix from a
+			single animation is still applied in place, which is faster.
+			Off by default.
+
+	@in		MOAISpineSkeleton self
+	@opt	bool	enabled		Default value is true.
+	@out	nil
+*/
+int MOAISpineSkeleton::_setPoseBlending ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" )
+	
+	self->mPoseBlending = state.GetValue < bool >( 2, true );
+	
+	if ( self->mAnimationState ) {
+		self->mAnimationState->poseBlending = self->mPoseBlending;
+	}
+	return 0;
+}
+
 //----------------------------------------------------------------//
 /**	@name	setSkin
 
@@ -318,12 +629,16 @@ int MOAISpineSkeleton::_setSkin	( lua_State* L ) {
 	
 	cc8* skinName = state.GetValue < cc8* >( 2, 0 );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
 	}
 	spSkeleton_setSkinByName ( self->mSkeleton, skinName );
 	spSkeleton_setSlotsToSetupPose( self->mSkeleton );
+	self->UpdateSkeleton ();
+	self->ScheduleUpdate ();
 	return 0;
 }
 
@@ -336,14 +651,60 @@ int MOAISpineSkeleton::_setSkin	( lua_State* L ) {
 int MOAISpineSkeleton::_setSlotsToSetupPose	( lua_State* L ) {
 	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
 	}
 	spSkeleton_setSlotsToSetupPose ( self->mSkeleton );
+	self->UpdateSkeleton ();
+	self->ScheduleUpdate ();
 	return 0;
 }
 
+//----------------------------------------------------------------//
+/**	@name	setSlotVisible
+	@text	Hides or shows a slot. Hidden slots are left out of the
+			bounds, vertex generation and drawing.
+
+	@in		MOAISpineSkeleton self
+	@in		string	slot name
+	@opt	bool	visible		Default value is true.
+	@out	bool	true if the slot was found
+*/
+int MOAISpineSkeleton::_setSlotVisible ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "US" );
+	
+	cc8* slotName = state.GetValue < cc8* >( 2, 0 );
+	bool visible = state.GetValue < bool >( 3, true );
+	
+	self->ForkInstance ();
+	
+	if ( !self->mSkeleton ) {
+		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
+		state.Push ( false );
+		return 1;
+	}
+	
+	int index = spSkeletonData_findSlotIndex ( self->mSkeleton->data, slotName );
+	if ( index >= 0 && self->mSlotHidden [ index ] == visible ) {
+		self->mSlotHidden [ index ] = !visible;
+		if ( visible ) {
+			self->mSlotsHidden--;
+		}
+		else {
+			self->mSlotsHidden++;
+		}
+		self->mBoundsDirty = true;
+		self->mRunsDirty = true;
+		self->mVerticesDirty = true;
+		self->ScheduleUpdate ();
+	}
+	state.Push ( index >= 0 );
+	return 1;
+}
+
 //----------------------------------------------------------------//
 /**	@name	setToSetupPose
 	
@@ -353,6 +714,8 @@ int MOAISpineSkeleton::_setSlotsToSetupPose	( lua_State* L ) {
 int MOAISpineSkeleton::_setToSetupPose ( lua_State* L ) {
 	MOAI_LUA_SETUP ( MOAISpineSkeleton, "U" );
 	
+	self->ForkInstance ();
+	
 	if ( !self->mSkeleton ) {
 		MOAIPrint ( "MOAISpineSkeleton not initialized \n" );
 		return 0;
@@ -362,6 +725,30 @@ int MOAISpineSkeleton::_setToSetupPose ( lua_State* L ) {
 	return 0;
 }
 
+//----------------------------------------------------------------//
+/**	@name	setUpdatePolicy
+	@text	Sets what the skeleton does when it is invisible or outside
+			every rectangle registered with MOAISpine.addViewRect.
+			UPDATE_TIME_WHEN_CULLED keeps the animation time and events
+			going but skips posing, UPDATE_PAUSE_WHEN_CULLED stops the
+			animation until the skeleton is visible again. With animation
+			bounds computed on the data, a skeleton that keeps time while
+			culled takes its bounds from them, so it comes back when its
+			animation moves it into view; otherwise its bounds stay where
+			it was culled.
+
+	@in		MOAISpineSkeleton self
+	@in		number	policy		UPDATE_ALWAYS, UPDATE_TIME_WHEN_CULLED or
+								UPDATE_PAUSE_WHEN_CULLED
+	@out	nil
+*/
+int MOAISpineSkeleton::_setUpdatePolicy ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeleton, "UN" )
+	
+	self->mUpdatePolicy = state.GetValue < u32 >( 2, UPDATE_ALWAYS );
+	return 0;
+}
+
 //================================================================//
 // MOAISpineSkeleton
 //================================================================//
@@ -374,6 +761,18 @@ void MOAISpineSkeleton::AddAnimation ( int trackId, cc8* name, bool loop, float
 	spAnimationState_addAnimation ( mAnimationState, trackId, anim, loop, delay );
 }
 
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::AffirmAnimationState () {
+	
+	if ( mAnimationState ) return;
+	
+	MOAISpineSkeletonData* skeletonData = mSkeletonData;
+	spAnimationStateData* data = skeletonData && skeletonData->mAnimationStateData ?
+		spAnimationStateData_createOverride ( skeletonData->mAnimationStateData ) :
+		spAnimationStateData_create ( mSkeleton->data );
+	this->InitAnimationState ( data );
+}
+
 //----------------------------------------------------------------//
 void MOAISpineSkeleton::AffirmBoneHierarchy ( spBone* bone ) {
 	// create all missing MOAISpineBones first
@@ -403,6 +802,55 @@ void MOAISpineSkeleton::AffirmBoneHierarchy ( spBone* bone ) {
 	}
 }
 
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::BlendLodPoses ( u32 interval, u32 mode, bool posed ) {
+	
+	if ( posed ) {
+		this->CapturePose ();
+		mLodStep = 0;
+	}
+	else {
+		// nothing sampled yet, the skeleton keeps its pose
+		if ( !mLodSampled ) return;
+		mLodStep++;
+	}
+	
+	float alpha = ( float )mLodStep / ( float )interval;
+	if ( mode == MOAISpine::LOD_EXTRAPOLATE ) {
+		if ( posed ) return;
+		alpha += 1.0f;
+	}
+	this->BlendPoses ( alpha );
+}
+
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::BlendPoses ( float alpha ) {
+	
+	spSkeletonPose_copy ( mLodPoses [ 2 ], mLodPoses [ 0 ]);
+	spSkeletonPose_blend ( mLodPoses [ 2 ], mLodPoses [ 1 ], alpha );
+	spSkeletonPose_restore ( mLodPoses [ 2 ], mSkeleton );
+}
+
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::CapturePose () {
+	
+	if ( !mLodPoses [ 0 ]) {
+		for ( u32 i = 0; i < 3; ++i ) {
+			mLodPoses [ i ] = spSkeletonPose_create ( mSkeleton->boneCount, mSkeleton->slotCount );
+		}
+	}
+	
+	spSkeletonPose* last = mLodPoses [ 0 ];
+	mLodPoses [ 0 ] = mLodPoses [ 1 ];
+	mLodPoses [ 1 ] = last;
+	
+	spSkeletonPose_capture ( mLodPoses [ 1 ], mSkeleton );
+	if ( !mLodSampled ) {
+		spSkeletonPose_copy ( mLodPoses [ 0 ], mLodPoses [ 1 ]);
+		mLodSampled = true;
+	}
+}
+
 //----------------------------------------------------------------//
 void MOAISpineSkeleton::ClearAllTracks () {
 	spAnimationState_clearTracks ( mAnimationState );
@@ -418,6 +866,25 @@ void MOAISpineSkeleton::Draw ( int subPrimID ) {
 	UNUSED ( subPrimID );
 	
 	if ( !this->IsVisible () ) return;
+	
+	MOAISpine& spine = MOAISpine::Get ();
+	MOAISpineStats& stats = spine.GetStats ();
+	
+	// instances draw their master's pose
+	MOAISpineSkeleton* source = this->GetPoseSource ();
+	
+	// hidden and transparent slots are both counted once per draw; the runs are current before either is counted
+	source->UpdateRuns ();
+	stats.mSlotsSkipped += source->mQuadsHidden;
+	
+	// a transparent skeleton or prop draws nothing, so it skips vertex generation and render state too
+	float a = source->mSkeleton->a * this->mColor.mA;
+	if ( a <= 0.0f ) {
+		stats.mSlotsSkipped += source->mQuadSlots.GetTop ();
+		return;
+	}
+	
+	double startTime = ZLDeviceTime::GetTimeInSeconds ();
 		
 	MOAIGfxDevice& gfxDevice = MOAIGfxDevice::Get ();
 	
@@ -435,49 +902,135 @@ void MOAISpineSkeleton::Draw ( int subPrimID ) {
 		gfxDevice.SetShaderPreset ( MOAIShaderMgr::DECK2D_SHADER );
 	}
 	
-	gfxDevice.SetVertexTransform ( MOAIGfxDevice::VTX_WORLD_TRANSFORM, this->GetLocalToWorldMtx ());
+	// batched skeletons write world space vertices, so consecutive skeletons keep the transform and share draws
+	bool batching = spine.GetBatching ();
+	const ZLAffine3D& mtx = this->GetLocalToWorldMtx ();
+	
+	if ( batching ) {
+		gfxDevice.SetVertexTransform ( MOAIGfxDevice::VTX_WORLD_TRANSFORM );
+	}
+	else {
+		gfxDevice.SetVertexTransform ( MOAIGfxDevice::VTX_WORLD_TRANSFORM, mtx );
+	}
 	gfxDevice.SetVertexMtxMode ( MOAIGfxDevice::VTX_STAGE_MODEL, MOAIGfxDevice::VTX_STAGE_PROJ );
 	gfxDevice.SetUVMtxMode ( MOAIGfxDevice::UV_STAGE_MODEL, MOAIGfxDevice::UV_STAGE_TEXTURE );
 
 	MOAIQuadBrush::BindVertexFormat ( gfxDevice );
 	
-	MOAIBlendMode normal;
-	MOAIBlendMode additive;
-	normal.SetBlend ( MOAIBlendMode::BLEND_NORMAL );
-	additive.SetBlend ( MOAIBlendMode::BLEND_ADD );
-
-	u32 size = this->mQuads.Size ();
-	for ( u32 i = 0; i < size; ++i ) {
-		spSlot* slot = mSkeleton->drawOrder [ i ];
-		
-		if ( !slot->attachment || slot->attachment->type != ATTACHMENT_REGION)
-			continue;
-		
-		spRegionAttachment *attachment = (spRegionAttachment*) slot->attachment;
-		MOAITexture* texture = (MOAITexture*) ((spAtlasRegion*) attachment->rendererObject)->page->rendererObject;
+	source->UpdateVertices ();
+	spSkeleton* skeleton = source->mSkeleton;
+	
+	const ZLColorVec& baseColor = this->mColor;
+	float r = skeleton->r * baseColor.mR;
+	float g = skeleton->g * baseColor.mG;
+	float b = skeleton->b * baseColor.mB;
+	
+	// corners of the two triangles, in the order MOAIQuadBrush draws them
+	static const u32 corners [ 6 ] = { 0, 1, 3, 1, 2, 3 };
+	
+	// each run is drawn as one batch; the device only flushes when the texture or blend mode changes
+	u32 totalRuns = source->mTotalRuns;
+	for ( u32 i = 0; i < totalRuns; ++i ) {
+		const spRegionRun& run = source->mRuns [ i ];
+		MOAITexture* texture = ( MOAITexture* )run.page->rendererObject;
+		bool additive = run.additive != 0;
 		
-		gfxDevice.SetTexture ( texture );
+		// neighbouring runs differ in texture or blend mode, rarely both; the first run always sets both
+		if (( i == 0 ) || ( run.page != source->mRuns [ i - 1 ].page )) {
+			gfxDevice.SetTexture ( texture );
+			stats.mStateChanges++;
+		}
+		else {
+			stats.mStateChangesSkipped++;
+		}
 		
-		if ( slot->data->additiveBlending ) {
-			gfxDevice.SetBlendMode ( additive );
+		if (( i == 0 ) || ( run.additive != source->mRuns [ i - 1 ].additive )) {
+			gfxDevice.SetBlendMode ( spine.GetBlendMode ( additive ));
+			stats.mStateChanges++;
 		}
 		else {
-			gfxDevice.SetBlendMode ( normal );
+			stats.mStateChangesSkipped++;
+		}
+		spine.CountRun ( texture, additive, this->mShader, !batching && ( i == 0 ));
+		
+		for ( int quad = run.start; quad < run.start + run.count; ++quad ) {
+			
+			// colors are read live, so slot colors set from Lua and the prop color apply without reposing
+			u32 slotIndex = source->mQuadSlots [ quad ];
+			spSlot* slot = skeleton->slots [ slotIndex ];
+			
+			// effects are often toggled by color timelines, leaving slots with nothing to draw
+			float alpha = a * slot->a;
+			if ( alpha <= 0.0f ) {
+				stats.mSlotsSkipped++;
+				continue;
+			}
+			
+			// atlas pages are loaded premultiplied, so the color is premultiplied to match; packed once per slot
+			u32 color = ZLColor::PackRGBA ( r * slot->r * alpha, g * slot->g * alpha, b * slot->b * alpha, alpha );
+			
+			const float* vertices = &source->mQuadVertices [ source->mSlotVertices [ slotIndex ]];
+			const float* uvs = source->mQuadAttachments [ quad ]->uvs;
+			
+			gfxDevice.BeginPrim ();
+			for ( u32 j = 0; j < 6; ++j ) {
+				u32 corner = corners [ j ] * 2;
+				float x = vertices [ corner ];
+				float y = vertices [ corner + 1 ];
+				
+				if ( batching ) {
+					x = mtx.m [ ZLAffine3D::C0_R0 ] * vertices [ corner ] + mtx.m [ ZLAffine3D::C1_R0 ] * vertices [ corner + 1 ] + mtx.m [ ZLAffine3D::C3_R0 ];
+					y = mtx.m [ ZLAffine3D::C0_R1 ] * vertices [ corner ] + mtx.m [ ZLAffine3D::C1_R1 ] * vertices [ corner + 1 ] + mtx.m [ ZLAffine3D::C3_R1 ];
+				}
+				gfxDevice.WriteVtx ( x, y, 0.0f );
+				gfxDevice.WriteUV ( uvs [ corner ], uvs [ corner + 1 ]);
+				gfxDevice.Write < u32 >( color );
+			}
+			gfxDevice.EndPrim ();
 		}
+	}
+	
+	stats.mDrawTime += ZLDeviceTime::GetTimeInSeconds () - startTime;
+}
+
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::DispatchQueuedEvents () {
+	
+	u32 count = mEventQueue.GetTop ();
+	if ( !count ) {
+		return;
+	}
+	
+	MOAIScopedLuaState state = MOAILuaRuntime::Get ().State ();
+	if ( !this->PushListenerAndSelf ( EVENT_ANIMATION_BATCH, state )) {
+		mEventQueue.Reset ();
+		return;
+	}
+	
+	lua_createtable ( state, count, 0 );
+	for ( u32 i = 0; i < count; ++i ) {
+		MOAISpineQueuedEvent& queued = mEventQueue [ i ];
 		
-		float a = slot->skeleton->a * slot->a;
-		float r = slot->skeleton->r * slot->r;
-		float g = slot->skeleton->g * slot->g;
-		float b = slot->skeleton->b * slot->b;
+		lua_createtable ( state, 0, 6 );
+		state.SetField ( -1, "type", ( u32 )( EVENT_ANIMATION_START + queued.mType ));
+		state.SetField ( -1, "track", queued.mTrackIndex );
 		
-		ZLColorVec slotColor (r, g, b, a);
-		ZLColorVec baseColor = this->mColor;
-		slotColor.Modulate ( baseColor );
-		gfxDevice.SetPenColor ( slotColor );
+		if ( queued.mType == ANIMATION_COMPLETE ) {
+			state.SetField ( -1, "loopCount", queued.mLoopCount );
+		}
 		
-		MOAIQuadBrush& quad = mQuads [ i ];
-		quad.Draw ();
+		if ( queued.mEvent ) {
+			state.SetField ( -1, "name", queued.mEvent->data->name );
+			state.SetField ( -1, "int", queued.mEvent->intValue );
+			state.SetField ( -1, "float", queued.mEvent->floatValue );
+			state.SetField ( -1, "string", queued.mEvent->stringValue );
+		}
+		lua_rawseti ( state, -2, i + 1 );
 	}
+	
+	// the listener may start animations, which queue new events
+	mEventQueue.Reset ();
+	state.DebugCall ( 2, 0 );
 }
 
 //----------------------------------------------------------------//
@@ -487,6 +1040,101 @@ void MOAISpineSkeleton::DrawDebug ( int subPrimID ) {
 	
 }
 
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::ForkInstance () {
+	
+	MOAISpineSkeleton* master = mMaster;
+	if ( !master ) return;
+	
+	// take over the master's pose so the fork continues where the master is
+	spSkeleton* from = master->mSkeleton;
+	spSkeleton_setSkin ( mSkeleton, from->skin );
+	mSkeleton->flipX = from->flipX;
+	mSkeleton->flipY = from->flipY;
+	mSkeleton->r = from->r;
+	mSkeleton->g = from->g;
+	mSkeleton->b = from->b;
+	mSkeleton->a = from->a;
+	mSkeleton->time = from->time;
+	
+	spSkeletonPose* pose = spSkeletonPose_create ( from->boneCount, from->slotCount );
+	spSkeletonPose_capture ( pose, from );
+	spSkeletonPose_restore ( pose, mSkeleton );
+	spSkeletonPose_dispose ( pose );
+	
+	for ( int i = 0; i < from->slotCount; ++i ) {
+		spSlot_setAttachment ( mSkeleton->slots [ i ], from->slots [ i ]->attachment );
+		mSlotHidden [ i ] = master->mSlotHidden [ i ];
+		
+		// both skeletons share the slot data, which identifies the slot
+		for ( int j = 0; j < from->slotCount; ++j ) {
+			if ( mSkeleton->slots [ j ]->data == from->drawOrder [ i ]->data ) {
+				mSkeleton->drawOrder [ i ] = mSkeleton->slots [ j ];
+				break;
+			}
+		}
+	}
+	
+	if ( master->mAnimationState ) {
+		this->AffirmAnimationState ();
+		spAnimationState_copyTracks ( mAnimationState, master->mAnimationState );
+	}
+	
+	mSlotsHidden = master->mSlotsHidden;
+	
+	mMaster.Set ( *this, 0 );
+	mLodStale = true;
+	
+	this->UpdateSkeleton ();
+	this->ScheduleUpdate ();
+}
+
+//----------------------------------------------------------------//
+bool MOAISpineSkeleton::GetAnimationBounds ( ZLBox& bounds ) {
+	
+	spSkeletonData* data = mSkeleton->data;
+	if ( !data->animationBounds || !mAnimationState ) {
+		return false;
+	}
+	
+	// locked bones are posed by their transforms, which the boxes know nothing about
+	for ( BoneTransformIt it = mBoneTransformMap.begin (); it != mBoneTransformMap.end (); ++it ) {
+		if ( it->second->mLockFlags ) {
+			return false;
+		}
+	}
+	
+	// tracks layer over each other, so only a single track is covered by its boxes; a mix takes the union of its entries
+	spTrackEntry* current = 0;
+	for ( int i = 0; i < mAnimationState->trackCount; ++i ) {
+		if ( !mAnimationState->tracks [ i ]) continue;
+		if ( current ) return false;
+		current = mAnimationState->tracks [ i ];
+	}
+	if ( !current ) {
+		return false;
+	}
+	
+	float box [ 4 ] = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for ( spTrackEntry* entry = current; entry; entry = entry->previous ) {
+		if ( !spSkeletonData_growAnimationBounds ( data, entry->animation, entry->time, entry->loop, box )) {
+			return false;
+		}
+	}
+	if ( box [ 0 ] > box [ 2 ]) {
+		return false;
+	}
+	
+	// the boxes are unflipped and relative to the skeleton's position
+	float minX = mSkeleton->flipX ? -box [ 2 ] : box [ 0 ];
+	float maxX = mSkeleton->flipX ? -box [ 0 ] : box [ 2 ];
+	float minY = mSkeleton->flipY ? -box [ 3 ] : box [ 1 ];
+	float maxY = mSkeleton->flipY ? -box [ 1 ] : box [ 3 ];
+	
+	bounds.Init ( mSkeleton->x + minX, mSkeleton->y + maxY, mSkeleton->x + maxX, mSkeleton->y + minY, 0.f, 0.f );
+	return true;
+}
+
 //----------------------------------------------------------------//
 u32 MOAISpineSkeleton::GetPropBounds ( ZLBox &bounds ) {
 	
@@ -501,22 +1149,68 @@ u32 MOAISpineSkeleton::GetPropBounds ( ZLBox &bounds ) {
 		return MOAIProp::BOUNDS_EMPTY;
 	}
 	
-	this->UpdateBoundsAndQuads ();
-	bounds.Init ( mSkeletonBounds );
+	// a skeleton culled while keeping time has a stale pose, so its bounds come from the animation boxes, which follow the
+	// tracks; a posed skeleton uses its own bounds, which are tighter and include LOD and fixed step blending
+	MOAISpineSkeleton* source = this->GetPoseSource ();
+	if ( !source->mKeepingTime || !source->GetAnimationBounds ( bounds )) {
+		source->UpdateBounds ();
+		bounds.Init ( source->mSkeletonBounds );
+	}
 	
 	return MOAIProp::BOUNDS_OK;
 }
 
+//----------------------------------------------------------------//
+MOAISpineSkeleton* MOAISpineSkeleton::GetPoseSource () {
+	
+	MOAISpineSkeleton* master = mMaster;
+	return master ? master->GetPoseSource () : this;
+}
+
 //----------------------------------------------------------------//
 void MOAISpineSkeleton::Init ( spSkeletonData *skeletonData ) {
 	
 	mSkeleton = spSkeleton_create ( skeletonData );
 	
-	u32 total = mSkeleton->slotCount;
-	mQuads.Init ( total );
+	mWorldPose = spSkeletonPose_create ( skeletonData->boneCount, 0 );
+	mWorldAttachments.Init ( skeletonData->slotCount );
+	mWorldDrawOrder.Init ( skeletonData->slotCount );
+	mDrawOrderIndices.Init ( skeletonData->slotCount );
+	mSlotVertices.Init ( skeletonData->slotCount );
+	mRuns.Init ( skeletonData->slotCount );
+	
+	// bounds come from these radii, so culling queries never generate vertices
+	mSlotRadii.Init ( skeletonData->slotCount );
+	mSlotHidden.Init ( skeletonData->slotCount );
+	for ( int i = 0; i < skeletonData->slotCount; ++i ) {
+		mSlotRadii [ i ] = 0.0f;
+		mSlotHidden [ i ] = false;
+		mWorldAttachments [ i ] = 0;
+		mWorldDrawOrder [ i ] = 0;
+	}
+	
+	for ( int i = -1; i < skeletonData->skinCount; ++i ) {
+		spSkin* skin = i < 0 ? skeletonData->defaultSkin : skeletonData->skins [ i ];
+		if ( !skin ) continue;
+		
+		for ( int slotIndex = 0; slotIndex < skeletonData->slotCount; ++slotIndex ) {
+			cc8* name;
+			for ( int j = 0; ( name = spSkin_getAttachmentName ( skin, slotIndex, j )); ++j ) {
+				
+				spAttachment* attachment = spSkin_getAttachment ( skin, slotIndex, name );
+				if ( !attachment || attachment->type != ATTACHMENT_REGION ) continue;
+				
+				const float* offset = (( spRegionAttachment* )attachment )->offset;
+				for ( u32 corner = 0; corner < 8; corner += 2 ) {
+					float radius = sqrtf ( offset [ corner ] * offset [ corner ] + offset [ corner + 1 ] * offset [ corner + 1 ]);
+					mSlotRadii [ slotIndex ] = fmax ( mSlotRadii [ slotIndex ], radius );
+				}
+			}
+		}
+	}
 	
 	this->UpdateSkeleton ();
-	this->UpdateBoundsAndQuads ();
+	this->UpdateBounds ();
 }
 
 //----------------------------------------------------------------//
@@ -525,6 +1219,17 @@ void MOAISpineSkeleton::InitAnimationState ( spAnimationStateData *animData ) {
 	mAnimationState = spAnimationState_create ( animData );
 	mAnimationState->context = this;
 	mAnimationState->listener = callback;
+	mAnimationState->mixer = mBakedPlayback ? bakedMixer : 0;
+	mAnimationState->poseBlending = mPoseBlending;
+}
+
+//----------------------------------------------------------------//
+bool MOAISpineSkeleton::IsCulled () {
+	
+	if ( !this->IsVisible ()) {
+		return true;
+	}
+	return MOAISpine::Get ().IsCulled ( mWorldBounds );
 }
 
 //----------------------------------------------------------------//
@@ -536,20 +1241,46 @@ bool MOAISpineSkeleton::IsDone () {
 MOAISpineSkeleton::MOAISpineSkeleton ():
 	mSkeleton ( 0 ),
 	mAnimationState ( 0 ),
+	mBakedPlayback ( false ),
 	mDebugBones ( false ),
 	mDebugSlots ( false ),
 	mBoundsDirty ( true ),
+	mRunsDirty ( true ),
+	mQuadsHidden ( 0 ),
+	mTotalRuns ( 0 ),
+	mSlotsHidden ( 0 ),
+	mEventBatching ( false ),
+	mPoseBlending ( false ),
+	mVerticesDirty ( true ),
+	mEventMask ( 0xffffffff ),
+	mEventsFired ( 0 ),
+	mLuaListenerMask ( 0 ),
+	mUpdatePolicy ( UPDATE_ALWAYS ),
+	mKeepingTime ( false ),
+	mFixedStep ( 0.0f ),
+	mFixedSteps ( 0 ),
+	mLodLevel ( 0 ),
+	mLodCounter ( sLodCounter++ ),
+	mLodStep ( 0 ),
+	mLodStale ( true ),
+	mLodSampled ( false ),
+	mWorldStale ( true ),
+	mWorldFlipX ( 0 ),
+	mWorldFlipY ( 0 ),
+	mWorldPose ( 0 ),
+	mListener ( 0 ),
 	mRootBone ( 0 ) {
 	
 	RTTI_BEGIN
 		RTTI_EXTEND ( MOAIProp )
 		RTTI_EXTEND ( MOAIAction )
 	RTTI_END
+	
+	memset ( mLodPoses, 0, sizeof ( mLodPoses ));
 }
 
 //----------------------------------------------------------------//
 MOAISpineSkeleton::~MOAISpineSkeleton () {
-	mQuads.Clear ();
 	
 	if ( mRootBone ) {
 		mRootBone->SetAsRootBone ( 0 );
@@ -568,19 +1299,84 @@ MOAISpineSkeleton::~MOAISpineSkeleton () {
 	mSlotColorMap.clear ();
 	
 	if ( mAnimationState ) {
+		// only this skeleton's overrides; the shared mixes belong to the skeleton data
 		spAnimationStateData_dispose ( mAnimationState->data );
 		spAnimationState_dispose ( mAnimationState );
 	}
 	
+	for ( u32 i = 0; i < 3; ++i ) {
+		if ( mLodPoses [ i ]) {
+			spSkeletonPose_dispose ( mLodPoses [ i ]);
+		}
+	}
+	
+	if ( mFixedSteps ) {
+		spFixedStep_dispose ( mFixedSteps );
+	}
+	
+	if ( mWorldPose ) {
+		spSkeletonPose_dispose ( mWorldPose );
+	}
+	
 	if ( mSkeleton ) {
 		spSkeleton_dispose ( mSkeleton );
 	}
 	
+	mMaster.Set ( *this, 0 );
 	mSkeletonData.Set ( *this, 0 );
 }
 
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::MixBakedAnimation ( spAnimation* animation, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events, int* eventCount, float alpha ) {
+	
+	MOAISpineSkeletonData* data = mSkeletonData;
+	spBakedAnimation* baked = data ? data->AffirmBakedAnimation ( animation ) : 0;
+	
+	if ( baked ) {
+		spBakedAnimation_apply ( baked, skeleton, lastTime, time, loop, events, eventCount, alpha );
+	}
+	else {
+		spAnimation_mix ( animation, skeleton, lastTime, time, loop, events, eventCount, alpha );
+	}
+}
+
 //----------------------------------------------------------------//
 void MOAISpineSkeleton::OnAnimationEvent ( int trackIndex, spEventType type, spEvent* event, int loopCount ) {
+	
+	if ( type == ANIMATION_EVENT ) {
+		mEventsFired++;
+	}
+	
+	if ( mListener ) {
+		mListener->OnSpineEvent ( this, trackIndex, type, event, loopCount );
+	}
+	
+	MOAISpineListener* globalListener = MOAISpine::Get ().GetNativeListener ();
+	if ( globalListener ) {
+		globalListener->OnSpineEvent ( this, trackIndex, type, event, loopCount );
+	}
+	
+	if ( !( mEventMask & ( 1 << type ))) {
+		return;
+	}
+	
+	if ( mEventBatching ) {
+		if ( !( mLuaListenerMask & ( 1 << ( EVENT_ANIMATION_BATCH - EVENT_ANIMATION_START )))) {
+			return;
+		}
+		
+		MOAISpineQueuedEvent& queued = mEventQueue.Push ();
+		queued.mTrackIndex = trackIndex;
+		queued.mType = type;
+		queued.mEvent = event;
+		queued.mLoopCount = loopCount;
+		return;
+	}
+	
+	if ( !( mLuaListenerMask & ( 1 << type ))) {
+		return;
+	}
+	
 	MOAIScopedLuaState state = MOAILuaRuntime::Get ().State ();
 	switch ( type ) {
 		case ANIMATION_START:
@@ -630,11 +1426,89 @@ void MOAISpineSkeleton::OnDepNodeUpdate () {
 //----------------------------------------------------------------//
 void MOAISpineSkeleton::OnUpdate ( float step ) {
 	if ( mSkeleton ) {
-		spSkeleton_update ( mSkeleton, step );
+		MOAISpine& spine = MOAISpine::Get ();
+		MOAISpineStats& stats = spine.GetStats ();
+		
+		// the master poses for its instances; only follow its bounds
+		if ( mMaster ) {
+			stats.mSkeletonsInstanced++;
+			this->ScheduleUpdate ();
+			return;
+		}
+		
+		bool culled = ( mUpdatePolicy != UPDATE_ALWAYS ) && this->IsCulled ();
+		
+		if ( culled ) {
+			stats.mSkeletonsCulled++;
+			if ( mUpdatePolicy == UPDATE_PAUSE_WHEN_CULLED ) {
+				return;
+			}
+		}
+		
+		const MOAISpineLod& lod = spine.GetLod ( mLodLevel >= 0 ? ( u32 )mLodLevel : spine.SelectLod ( mWorldBounds ));
+		
+		bool posing;
+		mEventsFired = 0;
+		
+		if ( mFixedStep > 0.0f ) {
+			posing = this->StepFixed ( step, culled, lod.mTimelineMask );
+		}
+		else {
+			// skeletons are given consecutive counters, so those at the same interval take turns
+			posing = !culled && ( mLodStale || ( ++mLodCounter % lod.mInterval ) == 0 );
+			
+			spSkeleton_update ( mSkeleton, step );
+			
+			if ( mAnimationState ) {
+				spAnimationState_update ( mAnimationState, step );
+				
+				if ( posing ) {
+					mAnimationState->timelineMask = lod.mTimelineMask;
+					spAnimationState_apply ( mAnimationState, mSkeleton );
+				}
+				else {
+					spAnimationState_applyEvents ( mAnimationState, mSkeleton );
+				}
+			}
+		}
 		
-		if ( mAnimationState ) {
-			spAnimationState_update ( mAnimationState, step );
-			spAnimationState_apply ( mAnimationState, mSkeleton );
+		stats.mEventsFired += mEventsFired;
+		if ( mEventsFired > stats.mMaxEventsFired ) {
+			stats.mMaxEventsFired = mEventsFired;
+		}
+		
+		if ( mEventBatching ) {
+			this->DispatchQueuedEvents ();
+		}
+		
+		// nothing to pose or draw; the animation boxes move with the tracks, so the bounds are refreshed for the next cull
+		// test, and without them the bounds keep their last value
+		if ( culled ) {
+			mLodStale = true;
+			mLodSampled = false;
+			mKeepingTime = true;
+			if ( mFixedSteps ) {
+				mFixedSteps->sampled = 0;
+			}
+			
+			ZLBox animationBounds;
+			if ( this->GetAnimationBounds ( animationBounds )) {
+				this->ScheduleUpdate ();
+			}
+			return;
+		}
+		mLodStale = false;
+		mKeepingTime = false;
+		
+		if ( mFixedStep > 0.0f ) {
+			if ( !posing ) return;
+		}
+		else if (( lod.mInterval > 1 ) && ( lod.mMode != MOAISpine::LOD_HOLD )) {
+			this->BlendLodPoses ( lod.mInterval, lod.mMode, posing );
+		}
+		else {
+			mLodSampled = false;
+			if ( !posing ) return;
 		}
 		
 		if ( mRootBone ) {
@@ -659,6 +1533,11 @@ void MOAISpineSkeleton::RegisterLuaClass ( MOAILuaState& state ) {
 	state.SetField ( -1, "EVENT_ANIMATION_END", ( u32 )EVENT_ANIMATION_END );
 	state.SetField ( -1, "EVENT_ANIMATION_COMPLETE", ( u32 )EVENT_ANIMATION_COMPLETE );
 	state.SetField ( -1, "EVENT_ANIMATION_EVENT", ( u32 )EVENT_ANIMATION_EVENT );
+	state.SetField ( -1, "EVENT_ANIMATION_BATCH", ( u32 )EVENT_ANIMATION_BATCH );
+	
+	state.SetField ( -1, "UPDATE_ALWAYS", ( u32 )UPDATE_ALWAYS );
+	state.SetField ( -1, "UPDATE_TIME_WHEN_CULLED", ( u32 )UPDATE_TIME_WHEN_CULLED );
+	state.SetField ( -1, "UPDATE_PAUSE_WHEN_CULLED", ( u32 )UPDATE_PAUSE_WHEN_CULLED );
 }
 
 //----------------------------------------------------------------//
@@ -672,17 +1551,29 @@ void MOAISpineSkeleton::RegisterLuaFuncs ( MOAILuaState& state ) {
 		{ "clearAllTracks", 		_clearAllTracks },
 		{ "clearTrack", 			_clearTrack },
 		{ "getBone",				_getBone },
+		{ "getEventsFired",			_getEventsFired },
 		{ "getSlot",				_getSlot },
 		{ "init", 					_init },
 		{ "initAnimationState", 	_initAnimationState },
 		{ "setAnimation", 			_setAnimation },
 		{ "setAttachment", 			_setAttachment },
+		{ "setBakedPlayback", 		_setBakedPlayback },
 		{ "setBonesToSetupPose", 	_setBonesToSetupPose },
+		{ "setEventBatching", 		_setEventBatching },
+		{ "setEventMask", 			_setEventMask },
+		{ "setFixedStep", 			_setFixedStep },
 		{ "setFlip", 				_setFlip },
+		{ "setInstanceOf", 			_setInstanceOf },
+		{ "setListener", 			_setListener },
+		{ "setLodLevel", 			_setLodLevel },
 		{ "setMix", 				_setMix },
+		{ "setMixes", 				_setMixes },
+		{ "setPoseBlending", 		_setPoseBlending },
 		{ "setSkin", 				_setSkin },
 		{ "setSlotsToSetupPose", 	_setSlotsToSetupPose },
+		{ "setSlotVisible", 		_setSlotVisible },
 		{ "setToSetupPose", 		_setToSetupPose },
+		{ "setUpdatePolicy", 		_setUpdatePolicy },
 		{ NULL, NULL }
 	};
 	
@@ -702,65 +1593,195 @@ void MOAISpineSkeleton::SetMix ( cc8* fromName, cc8* toName, float duration ) {
 	spAnimation* fromAnim = spSkeletonData_findAnimation ( mSkeleton->data, fromName );
 	spAnimation* toAnim = spSkeletonData_findAnimation ( mSkeleton->data, toName );
 	
-	assert ( fromAnim );
-	assert ( toAnim );
-	spAnimationStateData_setMix ( mAnimationState->data, fromAnim, toAnim, duration );
+	if ( !spAnimationStateData_setMix ( mAnimationState->data, fromAnim, toAnim, duration )) {
+		MOAIPrint ( "MOAISpineSkeleton: no mix from '%s' to '%s', animation not found \n", fromName, toName );
+	}
+}
+
+//----------------------------------------------------------------//
+bool MOAISpineSkeleton::StepFixed ( float step, bool culled, int timelineMask ) {
+	
+	if ( !mFixedSteps ) {
+		mFixedSteps = spFixedStep_create ( mFixedStep, mSkeleton->boneCount, mSkeleton->slotCount );
+	}
+	
+	if ( mAnimationState ) {
+		mAnimationState->timelineMask = timelineMask;
+	}
+	
+	int steps = spFixedStep_advance ( mFixedSteps, mSkeleton, step );
+	for ( int i = 0; i < steps; ++i ) {
+		spFixedStep_step ( mFixedSteps, mSkeleton, mAnimationState, !culled );
+	}
+	return !culled && spFixedStep_interpolate ( mFixedSteps, mSkeleton );
 }
 
 //----------------------------------------------------------------//
-void MOAISpineSkeleton::UpdateBoundsAndQuads () {
+void MOAISpineSkeleton::UpdateBounds () {
 	if ( !mBoundsDirty ) {
 		return;
 	}
 	mBoundsDirty = false;
 	
+	// conservative: a bone's world matrix is a rotation and a scale, so no corner lies further than the slot radius
+	// times the larger scale from the bone's origin
 	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
-	float vertices[8];
 	
-	u32 size = this->mQuads.Size ();
+	u32 size = mSkeleton->slotCount;
 	for ( u32 i = 0; i < size; ++i ) {
-		spSlot* slot = mSkeleton->drawOrder [ i ];
+		spSlot* slot = mSkeleton->slots [ i ];
 		
-		if ( !slot->attachment || slot->attachment->type != ATTACHMENT_REGION)
+		if ( !slot->attachment || slot->attachment->type != ATTACHMENT_REGION || mSlotHidden [ i ])
 			continue;
 		
-		spRegionAttachment *attachment = (spRegionAttachment*) slot->attachment;
-		spRegionAttachment_computeWorldVertices ( attachment, slot->skeleton->x, slot->skeleton->y, slot->bone, vertices );
-		
-		MOAIQuadBrush& quad = mQuads [ i ];
-		quad.SetVerts ( vertices );
-		quad.SetUVs ( attachment->uvs );
-		
-		minX = fmin ( minX, vertices[VERTEX_X1] );
-		minY = fmin ( minY, vertices[VERTEX_Y1] );
-		maxX = fmax ( maxX, vertices[VERTEX_X1] );
-		maxY = fmax ( maxY, vertices[VERTEX_Y1] );
-		minX = fmin ( minX, vertices[VERTEX_X4] );
-		minY = fmin ( minY, vertices[VERTEX_Y4] );
-		maxX = fmax ( maxX, vertices[VERTEX_X4] );
-		maxY = fmax ( maxY, vertices[VERTEX_Y4] );
-		minX = fmin ( minX, vertices[VERTEX_X2] );
-		minY = fmin ( minY, vertices[VERTEX_Y2] );
-		maxX = fmax ( maxX, vertices[VERTEX_X2] );
-		maxY = fmax ( maxY, vertices[VERTEX_Y2] );
-		minX = fmin ( minX, vertices[VERTEX_X3] );
-		minY = fmin ( minY, vertices[VERTEX_Y3] );
-		maxX = fmax ( maxX, vertices[VERTEX_X3] );
-		maxY = fmax ( maxY, vertices[VERTEX_Y3] );
+		// plain comparisons; fmin and fmax are library calls that cost more than the rest of the loop
+		spBone* bone = slot->bone;
+		float scaleX = bone->worldScaleX < 0.0f ? -bone->worldScaleX : bone->worldScaleX;
+		float scaleY = bone->worldScaleY < 0.0f ? -bone->worldScaleY : bone->worldScaleY;
+		float radius = mSlotRadii [ i ] * ( scaleX > scaleY ? scaleX : scaleY );
+		float x = mSkeleton->x + bone->worldX;
+		float y = mSkeleton->y + bone->worldY;
+		
+		if ( x - radius < minX ) minX = x - radius;
+		if ( y - radius < minY ) minY = y - radius;
+		if ( x + radius > maxX ) maxX = x + radius;
+		if ( y + radius > maxY ) maxY = y + radius;
 	}
 	
 	mSkeletonBounds.Init ( minX, maxY, maxX, minY, 0.f, 0.f );
 }
 
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::UpdateRuns () {
+	if ( !mRunsDirty ) {
+		return;
+	}
+	mRunsDirty = false;
+	
+	mQuadSlots.Reset ();
+	mQuadSlotPtrs.Reset ();
+	mQuadAttachments.Reset ();
+	mTotalRuns = 0;
+	mQuadsHidden = 0;
+	
+	// only the order is walked here; the vertices are by slot, so a draw order key never recomputes them
+	u32 size = mSkeleton->slotCount;
+	for ( u32 i = 0; i < size; ++i ) {
+		u32 index = mDrawOrderIndices [ i ];
+		spAttachment* worldAttachment = mWorldAttachments [ index ];
+		
+		if ( !worldAttachment || worldAttachment->type != ATTACHMENT_REGION)
+			continue;
+		
+		if ( mSlotHidden [ index ]) {
+			mQuadsHidden++;
+			continue;
+		}
+		
+		mQuadSlots.Push () = index;
+		mQuadSlotPtrs.Push () = mSkeleton->slots [ index ];
+		mQuadAttachments.Push () = ( spRegionAttachment* )worldAttachment;
+	}
+	
+	u32 totalQuads = mQuadSlots.GetTop ();
+	if ( totalQuads ) {
+		mTotalRuns = spRegionAttachment_splitRuns ( &mQuadSlotPtrs [ 0 ], &mQuadAttachments [ 0 ], totalQuads, &mRuns [ 0 ]);
+	}
+}
+
 //----------------------------------------------------------------//
 void MOAISpineSkeleton::UpdateSkeleton () {
 	
-	if ( !mSkeleton )
+	if ( !mSkeleton || mMaster )
 		return;
 	
-	spSkeleton_updateWorldTransform ( mSkeleton );
-	mBoundsDirty = true;
+	// paused, finished and static skeletons come back with the pose they had, which keeps its world transforms, vertices
+	// and bounds; colors are read when drawing, so they don't count
+	bool bonesChanged = mWorldStale || ( mWorldFlipX != mSkeleton->flipX ) || ( mWorldFlipY != mSkeleton->flipY );
+	mWorldStale = false;
+	
+	for ( BoneTransformIt it = mBoneTransformMap.begin (); it != mBoneTransformMap.end (); ++it ) {
+		bonesChanged = bonesChanged || it->second->mWorldDirty;
+		it->second->mWorldDirty = false;
+	}
+	
+	if ( bonesChanged || !spSkeletonPose_matchesBones ( mWorldPose, mSkeleton )) {
+		spSkeleton_updateWorldTransform ( mSkeleton );
+		spSkeletonPose_capture ( mWorldPose, mSkeleton );
+		mWorldFlipX = mSkeleton->flipX;
+		mWorldFlipY = mSkeleton->flipY;
+		bonesChanged = true;
+	}
+	
+	bool attachmentsChanged = false;
+	bool orderChanged = false;
+	for ( int i = 0; i < mSkeleton->slotCount; ++i ) {
+		if ( mWorldAttachments [ i ] != mSkeleton->slots [ i ]->attachment ) {
+			mWorldAttachments [ i ] = mSkeleton->slots [ i ]->attachment;
+			attachmentsChanged = true;
+		}
+		
+		// only the positions a draw order key moved are searched for their slot index
+		spSlot* slot = mSkeleton->drawOrder [ i ];
+		if ( mWorldDrawOrder [ i ] != slot ) {
+			u32 index = 0;
+			while ( mSkeleton->slots [ index ] != slot ) ++index;
+			
+			mWorldDrawOrder [ i ] = slot;
+			mDrawOrderIndices [ i ] = index;
+			orderChanged = true;
+		}
+	}
+	
+	MOAISpineStats& stats = MOAISpine::Get ().GetStats ();
+	
+	if ( bonesChanged || attachmentsChanged ) {
+		mBoundsDirty = true;
+		mVerticesDirty = true;
+	}
+	
+	if ( attachmentsChanged || orderChanged ) {
+		mRunsDirty = true;
+	}
+	
+	if ( bonesChanged || attachmentsChanged || orderChanged ) {
+		stats.mPosesUpdated++;
+	}
+	else {
+		stats.mPosesReused++;
+	}
 }
 
-
-
+//----------------------------------------------------------------//
+void MOAISpineSkeleton::UpdateVertices () {
+	if ( !mVerticesDirty ) {
+		return;
+	}
+	mVerticesDirty = false;
+	
+	mVertexSlots.Reset ();
+	mVertexAttachments.Reset ();
+	
+	// vertices, runs and UVs all come from the attachments UpdateSkeleton captured; everything that changes attachments
+	// calls it, so they never disagree about which slots have a region
+	u32 size = mSkeleton->slotCount;
+	for ( u32 i = 0; i < size; ++i ) {
+		spSlot* slot = mSkeleton->slots [ i ];
+		spAttachment* attachment = mWorldAttachments [ i ];
+		
+		if ( !attachment || attachment->type != ATTACHMENT_REGION || mSlotHidden [ i ])
+			continue;
+		
+		mSlotVertices [ i ] = mVertexSlots.GetTop () * 8;
+		mVertexSlots.Push () = slot;
+		mVertexAttachments.Push () = ( spRegionAttachment* )attachment;
+	}
+	
+	// the gathered slots are transformed in one pass; prop bounds come from UpdateBounds, so the kernel skips its bounds reduction
+	u32 totalVertexSlots = mVertexSlots.GetTop ();
+	
+	if ( totalVertexSlots ) {
+		mQuadVertices.Grow ( totalVertexSlots * 8 );
+		spRegionAttachment_computeWorldVerticesBatch ( &mVertexSlots [ 0 ], &mVertexAttachments [ 0 ], totalVertexSlots, mSkeleton->x, mSkeleton->y, &mQuadVertices [ 0 ], 0 );
+	}
+}
@@ -7,6 +7,7 @@
 #include <spine/spine.h>
 
 class MOAISpineBone;
+class MOAISpineSkeleton;
 class MOAISpineSlot;
 class MOAISpineSkeletonData;
 
@@ -19,6 +20,31 @@ public:
 	u32 mAttrID;
 };
 
+//================================================================//
+// MOAISpineListener
+//================================================================//
+/**	@name	MOAISpineListener
+	@text	Receives animation events natively, without going through
+			Lua. Called from inside the skeleton update.
+*/
+class MOAISpineListener {
+public:
+
+	//----------------------------------------------------------------//
+	virtual void	OnSpineEvent			( MOAISpineSkeleton* skeleton, int trackIndex, spEventType type, spEvent* event, int loopCount ) = 0;
+	virtual			~MOAISpineListener		() {}
+};
+
+//================================================================//
+// MOAISpineQueuedEvent
+//================================================================//
+class MOAISpineQueuedEvent {
+public:
+	int				mTrackIndex;
+	spEventType		mType;
+	spEvent*		mEvent;
+	int				mLoopCount;
+};
 
 //================================================================//
 // MOAISpineSkeleton
@@ -31,65 +57,143 @@ class MOAISpineSkeleton :
 	public MOAIAction {
 private:
 	
+	bool			mBakedPlayback;
 	bool			mDebugSlots;
 	bool			mDebugBones;
 	bool			mBoundsDirty;
+	bool			mRunsDirty;
+	bool			mEventBatching;
+	bool			mPoseBlending;
+	bool			mVerticesDirty;
+	u32				mEventMask;
+	u32				mEventsFired;
+	u32				mLuaListenerMask;
+	u32				mUpdatePolicy;
+	bool			mKeepingTime;		// culled and only keeping time, so the pose lags the tracks
+	
+	float			mFixedStep;			// 0 steps by the action's step
+	spFixedStep*	mFixedSteps;		// created on the first fixed step
+	
+	int				mLodLevel;			// -1 picks the level from the skeleton's size
+	u32				mLodCounter;
+	u32				mLodStep;			// updates since the last posing update
+	bool			mLodStale;			// pose on the next visible update
+	bool			mLodSampled;		// mLodPoses hold samples to blend
+	spSkeletonPose*	mLodPoses [ 3 ];	// last two posing updates and the blend of them
+	
+	// what the world transforms and vertices were last computed from
+	bool			mWorldStale;
+	int				mWorldFlipX;
+	int				mWorldFlipY;
+	spSkeletonPose*	mWorldPose;
+	ZLLeanArray < spAttachment* > mWorldAttachments;
+	ZLLeanArray < spSlot* > mWorldDrawOrder;
+	ZLLeanArray < u32 > mDrawOrderIndices;	// slot index at each draw order position, kept in step with mWorldDrawOrder
+	
+	MOAISpineListener* mListener;
 	ZLBox			mSkeletonBounds;
+	ZLLeanArray < float > mSlotRadii;	// furthest region corner any skin can attach to each slot, in bone space
+	ZLLeanArray < bool > mSlotHidden;	// slots left out of bounds, vertices and draw, by slot index
+	u32				mSlotsHidden;
 	
 	spSkeleton*		mSkeleton;
 	spAnimationState* mAnimationState;
 	MOAISpineBone*	mRootBone;
 		
 	MOAILuaSharedPtr < MOAISpineSkeletonData > mSkeletonData;
+	MOAILuaSharedPtr < MOAISpineSkeleton > mMaster;	// skeleton whose pose this instance draws
 	
-	ZLLeanArray < MOAIQuadBrush > mQuads;
+	// four world space corners per region attachment in slot order, so a new draw order only rebuilds the quads and runs
+	ZLLeanArray < float > mQuadVertices;
+	ZLLeanStack < spSlot* > mVertexSlots;	// slots the vertices were computed for
+	ZLLeanStack < spRegionAttachment* > mVertexAttachments;	// their captured attachments
+	ZLLeanArray < u32 > mSlotVertices;		// offset of each slot's corners in mQuadVertices, by slot index
+	ZLLeanStack < u32 > mQuadSlots;			// slot index of each quad in draw order
+	ZLLeanStack < spSlot* > mQuadSlotPtrs;	// the same slots, for spRegionAttachment_splitRuns
+	ZLLeanStack < spRegionAttachment* > mQuadAttachments;	// captured attachment of each quad in draw order
+	u32				mQuadsHidden;			// region attachments left out of the quads by hidden slots
+	ZLLeanArray < spRegionRun > mRuns;		// room for a run per slot
+	u32				mTotalRuns;
 	
 	typedef STLMap < STLString, MOAISpineBone* >::iterator BoneTransformIt;
 	STLMap < STLString, MOAISpineBone* > mBoneTransformMap;
 	
 	typedef STLMap < STLString, MOAISpineSlot* >::iterator SlotColorIt;
 	STLMap < STLString, MOAISpineSlot* > mSlotColorMap;
+	
+	ZLLeanStack < MOAISpineQueuedEvent > mEventQueue;
 		
 	//----------------------------------------------------------------//
 	static int		_addAnimation			( lua_State* L );
 	static int		_clearAllTracks			( lua_State* L );
 	static int		_clearTrack				( lua_State* L );
 	static int		_getBone				( lua_State* L );
+	static int		_getEventsFired			( lua_State* L );
 	static int		_getSlot				( lua_State* L );
 	static int		_init					( lua_State* L );
 	static int		_initAnimationState		( lua_State* L );
 	static int		_setAnimation			( lua_State* L );
 	static int		_setAttachment			( lua_State* L );
+	static int		_setBakedPlayback		( lua_State* L );
 	static int		_setBonesToSetupPose	( lua_State* L );
+	static int		_setEventBatching		( lua_State* L );
+	static int		_setEventMask			( lua_State* L );
+	static int		_setFixedStep			( lua_State* L );
 	static int		_setFlip				( lua_State* L );
+	static int		_setInstanceOf			( lua_State* L );
+	static int		_setListener			( lua_State* L );
+	static int		_setLodLevel			( lua_State* L );
 	static int		_setMix					( lua_State* L );
+	static int		_setMixes				( lua_State* L );
+	static int		_setPoseBlending		( lua_State* L );
 	static int		_setSkin				( lua_State* L );
 	static int		_setSlotsToSetupPose	( lua_State* L );
+	static int		_setSlotVisible			( lua_State* L );
 	static int		_setToSetupPose			( lua_State* L );
+	static int		_setUpdatePolicy		( lua_State* L );
 	
 public:
 	
 	DECL_LUA_FACTORY ( MOAISpineSkeleton )
+	
+	GET_SET ( MOAISpineListener*, NativeListener, mListener )
 			
 	enum {
 		EVENT_ANIMATION_START = MOAIAction::TOTAL_EVENTS,
 		EVENT_ANIMATION_END,
 		EVENT_ANIMATION_COMPLETE,
 		EVENT_ANIMATION_EVENT,
+		EVENT_ANIMATION_BATCH,
 		TOTAL_EVENTS
 	};
+	
+	enum {
+		UPDATE_ALWAYS,
+		UPDATE_TIME_WHEN_CULLED,
+		UPDATE_PAUSE_WHEN_CULLED,
+	};
 
 	//----------------------------------------------------------------//
 	void			AddAnimation			( int trackId, cc8* name, bool loop, float delay );
+	void			AffirmAnimationState	();
 	void			AffirmBoneHierarchy		( spBone* bone );
+	void			BlendLodPoses			( u32 interval, u32 mode, bool posed );
+	void			BlendPoses				( float alpha );
+	void			CapturePose				();
 	void			ClearAllTracks			();
 	void			ClearTrack				( int trackId );
 	void			Draw					( int subPrimID );
+	void			DispatchQueuedEvents	();
 	void			DrawDebug				( int subPrimID );
+	void			ForkInstance			();
+	bool			GetAnimationBounds		( ZLBox& bounds );
+	MOAISpineSkeleton*	GetPoseSource		();
 	u32				GetPropBounds			( ZLBox& bounds );
 	void			Init					( spSkeletonData* skeletonData );
 	void			InitAnimationState		( spAnimationStateData* animData );
+	bool			IsCulled				();
 	bool			IsDone					();
+	void			MixBakedAnimation		( spAnimation* animation, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events, int* eventCount, float alpha );
 					MOAISpineSkeleton		();
 					~MOAISpineSkeleton		();
 	
@@ -100,8 +204,11 @@ public:
 	void			RegisterLuaFuncs		( MOAILuaState& state );
 	void			SetAnimation			( int trackId, cc8* name, bool loop, float delay );
 	void			SetMix					( cc8* fromName, cc8* toName, float duration );
-	void			UpdateBoundsAndQuads	();
+	bool			StepFixed				( float step, bool culled, int timelineMask );
+	void			UpdateBounds			();
+	void			UpdateRuns				();
 	void			UpdateSkeleton			();
+	void			UpdateVertices			();
 };
 
 #endif
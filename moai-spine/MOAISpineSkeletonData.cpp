@@ -8,6 +8,93 @@
 // lua
 //================================================================//
 
+//----------------------------------------------------------------//
+/**	@name	bakeAnimations
+	@text	Samples every animation at a fixed rate for use by skeletons
+			with baked playback enabled. Animations are otherwise baked
+			on first use at the default rate of 30 samples per second.
+
+	@in		MOAISpineSkeletonData self
+	@opt	number	rate		samples per second. Default value is 30.
+	@out	nil
+*/
+int MOAISpineSkeletonData::_bakeAnimations ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "U" )
+	
+	if ( !self->mSkeletonData ) {
+		MOAIPrint ( "Empty skeleton data \n" );
+		return 0;
+	}
+	
+	self->ClearBakedAnimations ();
+	self->mBakeRate = state.GetValue < float >( 2, 30.0f );
+	
+	for ( int i = 0; i < self->mSkeletonData->animationCount; ++i ) {
+		self->AffirmBakedAnimation ( self->mSkeletonData->animations [ i ]);
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	compressAnimations
+	@text	Replaces bone and slot color keys with 16 bit quantized keys,
+			collapsing constant timelines and dropping keys that can be
+			interpolated within the tolerance.
+
+	@in		MOAISpineSkeletonData self
+	@opt	number	tolerance	in degrees for rotation and skeleton units
+								for translation, scale and color use a
+								hundredth of it. Default value is 0.
+	@out	nil
+*/
+int MOAISpineSkeletonData::_compressAnimations ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "U" )
+	
+	if ( !self->mSkeletonData ) {
+		MOAIPrint ( "Empty skeleton data \n" );
+		return 0;
+	}
+	
+	float tolerance = state.GetValue < float >( 2, 0.0f );
+	
+	self->ClearBakedAnimations ();
+	self->ClearBoneSamples ();
+	for ( int i = 0; i < self->mSkeletonData->animationCount; ++i ) {
+		spAnimation_compress ( self->mSkeletonData->animations [ i ], tolerance );
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	computeAnimationBounds
+	@text	Samples every animation and stores conservative bounds for
+			each of its segments. Skeletons that are culled and only keep
+			time report prop bounds from these while playing a single
+			track, so their bounds follow the animation without posing.
+			Drawn skeletons and skeletons with locked bones report their
+			posed bounds, which are tighter.
+
+	@in		MOAISpineSkeletonData self
+	@opt	number	sample rate in samples per second. Default value is 30.
+	@opt	number	segment duration in seconds, or 0 for one box per
+					animation. Default value is 0.25.
+	@out	nil
+*/
+int MOAISpineSkeletonData::_computeAnimationBounds ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "U" )
+	
+	if ( !self->mSkeletonData ) {
+		MOAIPrint ( "Empty skeleton data \n" );
+		return 0;
+	}
+	
+	float sampleRate = state.GetValue < float >( 2, 30.0f );
+	float segment = state.GetValue < float >( 3, 0.25f );
+	
+	spSkeletonData_computeAnimationBounds ( self->mSkeletonData, sampleRate, segment );
+	return 0;
+}
+
 //----------------------------------------------------------------//
 /**	@name	load
 
@@ -40,6 +127,126 @@ int MOAISpineSkeletonData::_load ( lua_State* L ) {
 		return 0;
 	}
 	
+	self->mAnimationStateData = spAnimationStateData_create ( self->mSkeletonData );
+	
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	sampleBone
+	@text	Returns a bone's world transform at a time of an animation,
+			without touching any skeleton. The time is rounded to the
+			sample rate and every bone is cached for the animation at
+			that sample, so repeated queries are cheap.
+
+	@in		MOAISpineSkeletonData self
+	@in		string	animation
+	@in		number	time
+	@in		string	bone
+	@opt	bool	loop		Default value is false.
+	@out	number	x			in skeleton space, before flipping
+	@out	number	y
+	@out	number	rotation	in degrees
+	@out	number	scaleX
+	@out	number	scaleY
+*/
+int MOAISpineSkeletonData::_sampleBone ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "USNS" )
+	
+	if ( !self->mSkeletonData ) {
+		MOAIPrint ( "Empty skeleton data \n" );
+		return 0;
+	}
+	
+	cc8* animationName = state.GetValue < cc8* >( 2, "" );
+	float time = state.GetValue < float >( 3, 0.0f );
+	cc8* boneName = state.GetValue < cc8* >( 4, "" );
+	bool loop = state.GetValue < bool >( 5, false );
+	
+	spAnimation* animation = spSkeletonData_findAnimation ( self->mSkeletonData, animationName );
+	int boneIndex = spSkeletonData_findBoneIndex ( self->mSkeletonData, boneName );
+	if ( !animation || boneIndex < 0 ) {
+		return 0;
+	}
+	
+	const MOAISpineBoneSample& sample = self->SampleBone ( animation, time, loop, boneIndex );
+	state.Push ( sample.mX );
+	state.Push ( sample.mY );
+	state.Push ( sample.mRotation );
+	state.Push ( sample.mScaleX );
+	state.Push ( sample.mScaleY );
+	return 5;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setMix
+	@text	Sets the mix duration used by every skeleton created from
+			this data, unless a skeleton overrides it.
+ 
+ 	@in		MOAISpineSkeletonData self
+	@in		string	from
+	@in		string	to
+	@in		number	duration
+	@out	nil
+*/
+int MOAISpineSkeletonData::_setMix ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "USSN" )
+	
+	if ( !self->mSkeletonData ) {
+		MOAIPrint ( "Empty skeleton data \n" );
+		return 0;
+	}
+	
+	cc8* fromName = state.GetValue < cc8* >( 2, "" );
+	cc8* toName = state.GetValue < cc8* >( 3, "" );
+	float duration = state.GetValue < float >( 4, 0.1f );
+	
+	self->SetMix ( fromName, toName, duration );
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setMixes
+	@text	Sets many shared mix durations at once.
+
+	@in		MOAISpineSkeletonData self
+	@in		table	mixes		array of { fromName, toName, duration }
+	@out	nil
+*/
+int MOAISpineSkeletonData::_setMixes ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "UT" )
+	
+	if ( !self->mSkeletonData ) {
+		MOAIPrint ( "Empty skeleton data \n" );
+		return 0;
+	}
+	
+	u32 count = state.GetTableSize ( 2 );
+	for ( u32 i = 1; i <= count; ++i ) {
+		lua_rawgeti ( state, 2, i );
+		cc8* fromName = state.GetField < cc8* >( -1, 1, "" );
+		cc8* toName = state.GetField < cc8* >( -1, 2, "" );
+		float duration = state.GetField < float >( -1, 3, 0.1f );
+		self->SetMix ( fromName, toName, duration );
+		state.Pop ( 1 );
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------//
+/**	@name	setSampleRate
+	@text	Sets how finely sampleBone rounds times. Clears the cached
+			samples.
+
+	@in		MOAISpineSkeletonData self
+	@opt	number	rate		samples per second. Default value is 60.
+	@out	nil
+*/
+int MOAISpineSkeletonData::_setSampleRate ( lua_State* L ) {
+	MOAI_LUA_SETUP ( MOAISpineSkeletonData, "U" )
+	
+	self->ClearBoneSamples ();
+	self->mSampleRate = state.GetValue < float >( 2, 60.0f );
 	return 0;
 }
 
@@ -47,10 +254,53 @@ int MOAISpineSkeletonData::_load ( lua_State* L ) {
 // MOAIFoo
 //================================================================//
 
+//----------------------------------------------------------------//
+spBakedAnimation* MOAISpineSkeletonData::AffirmBakedAnimation ( spAnimation* animation ) {
+	
+	BakedAnimationIt it = mBakedAnimations.find ( animation );
+	if ( it != mBakedAnimations.end ()) {
+		return it->second;
+	}
+	
+	spBakedAnimation* baked = spBakedAnimation_create ( animation, mSkeletonData, mBakeRate );
+	mBakedAnimations [ animation ] = baked;
+	return baked;
+}
+
+//----------------------------------------------------------------//
+void MOAISpineSkeletonData::ClearBakedAnimations () {
+	
+	for ( BakedAnimationIt it = mBakedAnimations.begin (); it != mBakedAnimations.end (); ++it ) {
+		spBakedAnimation_dispose ( it->second );
+	}
+	mBakedAnimations.clear ();
+}
+
+//----------------------------------------------------------------//
+void MOAISpineSkeletonData::ClearBoneSamples () {
+	
+	mBoneSampleIndex.clear ();
+	mBoneSamples.Reset ();
+}
+
+//----------------------------------------------------------------//
+void MOAISpineSkeletonData::SetMix ( cc8* fromName, cc8* toName, float duration ) {
+	spAnimation* fromAnim = spSkeletonData_findAnimation ( mSkeletonData, fromName );
+	spAnimation* toAnim = spSkeletonData_findAnimation ( mSkeletonData, toName );
+	
+	if ( !spAnimationStateData_setMix ( mAnimationStateData, fromAnim, toAnim, duration )) {
+		MOAIPrint ( "MOAISpineSkeletonData: no mix from '%s' to '%s', animation not found \n", fromName, toName );
+	}
+}
+
 //----------------------------------------------------------------//
 MOAISpineSkeletonData::MOAISpineSkeletonData ():
+	mBakeRate ( 30.0f ),
+	mSampleRate ( 60.0f ),
+	mSampleSkeleton ( 0 ),
 	mSkeletonData ( 0 ),
-	mAtlas ( 0 ) {
+	mAtlas ( 0 ),
+	mAnimationStateData ( 0 ) {
 	
 	RTTI_BEGIN
 		RTTI_EXTEND ( MOAILuaObject )
@@ -59,6 +309,16 @@ MOAISpineSkeletonData::MOAISpineSkeletonData ():
 
 //----------------------------------------------------------------//
 MOAISpineSkeletonData::~MOAISpineSkeletonData () {
+	this->ClearBakedAnimations ();
+	
+	if ( mSampleSkeleton ) {
+		spSkeleton_dispose ( mSampleSkeleton );
+	}
+	
+	if ( mAnimationStateData ) {
+		spAnimationStateData_dispose ( mAnimationStateData );
+	}
+	
 	if ( mSkeletonData ) {
 		spSkeletonData_dispose ( mSkeletonData );
 	}
@@ -77,10 +337,66 @@ void MOAISpineSkeletonData::RegisterLuaClass ( MOAILuaState &state ) {
 void MOAISpineSkeletonData::RegisterLuaFuncs ( MOAILuaState& state ) {
 	
 	luaL_Reg regTable [] = {
-		{ "load",	_load },
+		{ "bakeAnimations",		_bakeAnimations },
+		{ "compressAnimations",	_compressAnimations },
+		{ "computeAnimationBounds",	_computeAnimationBounds },
+		{ "load",				_load },
+		{ "sampleBone",			_sampleBone },
+		{ "setMix",				_setMix },
+		{ "setMixes",			_setMixes },
+		{ "setSampleRate",		_setSampleRate },
 		{ NULL, NULL }
 	};
 
 	luaL_register ( state, 0, regTable );
 }
 
+//----------------------------------------------------------------//
+const MOAISpineBoneSample& MOAISpineSkeletonData::SampleBone ( spAnimation* animation, float time, bool loop, int boneIndex ) {
+	
+	float duration = animation->duration;
+	if ( loop && duration > 0.0f ) {
+		time = fmodf ( time, duration );
+	}
+	time = time < 0.0f ? 0.0f : ( time > duration ? duration : time );
+	
+	u32 sample = ( u32 )( time * mSampleRate + 0.5f );
+	
+	u32 animationIndex = 0;
+	while ( mSkeletonData->animations [ animationIndex ] != animation ) {
+		animationIndex++;
+	}
+	u64 key = (( u64 )animationIndex << 32 ) | sample;
+	
+	BoneSampleIt it = mBoneSampleIndex.find ( key );
+	if ( it != mBoneSampleIndex.end ()) {
+		return mBoneSamples [ it->second + boneIndex ];
+	}
+	
+	if ( !mSampleSkeleton ) {
+		mSampleSkeleton = spSkeleton_create ( mSkeletonData );
+	}
+	
+	u32 boneCount = mSampleSkeleton->boneCount;
+	if ( mBoneSamples.GetTop () + boneCount > MAX_BONE_SAMPLES ) {
+		this->ClearBoneSamples ();
+	}
+	
+	spAnimation_sample ( animation, mSampleSkeleton, ( float )sample / mSampleRate, false );
+	spSkeleton_updateWorldTransform ( mSampleSkeleton );
+	
+	u32 base = mBoneSamples.GetTop ();
+	for ( u32 i = 0; i < boneCount; ++i ) {
+		spBone* bone = mSampleSkeleton->bones [ i ];
+		
+		MOAISpineBoneSample& boneSample = mBoneSamples.Push ();
+		boneSample.mX = bone->worldX;
+		boneSample.mY = bone->worldY;
+		boneSample.mRotation = bone->worldRotation;
+		boneSample.mScaleX = bone->worldScaleX;
+		boneSample.mScaleY = bone->worldScaleY;
+	}
+	mBoneSampleIndex [ key ] = base;
+	
+	return mBoneSamples [ base + boneIndex ];
+}
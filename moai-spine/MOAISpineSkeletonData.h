@@ -6,6 +6,18 @@
 
 #include <spine/spine.h>
 
+//================================================================//
+// MOAISpineBoneSample
+//================================================================//
+class MOAISpineBoneSample {
+public:
+	float	mX;
+	float	mY;
+	float	mRotation;
+	float	mScaleX;
+	float	mScaleY;
+};
+
 //================================================================//
 // MOAISpineSkeletonData
 //================================================================//
@@ -19,23 +31,55 @@ class MOAISpineSkeletonData :
 private:
 	
 	friend class MOAISpineSkeleton;
+	
+	typedef STLMap < spAnimation*, spBakedAnimation* >::iterator BakedAnimationIt;
+	STLMap < spAnimation*, spBakedAnimation* > mBakedAnimations;
+	float			mBakeRate;
+	
+	enum {
+		MAX_BONE_SAMPLES = 0x10000,
+	};
+	
+	// world transforms of every bone, boneCount at a time, keyed by animation index and sample
+	typedef STLMap < u64, u32 >::iterator BoneSampleIt;
+	STLMap < u64, u32 > mBoneSampleIndex;
+	ZLLeanStack < MOAISpineBoneSample > mBoneSamples;
+	float			mSampleRate;
+	spSkeleton*		mSampleSkeleton;
 		
 	//----------------------------------------------------------------//
+	static int		_bakeAnimations		( lua_State* L );
+	static int		_compressAnimations	( lua_State* L );
+	static int		_computeAnimationBounds	( lua_State* L );
 	static int		_load				( lua_State* L );
+	static int		_sampleBone			( lua_State* L );
+	static int		_setMix				( lua_State* L );
+	static int		_setMixes			( lua_State* L );
+	static int		_setSampleRate		( lua_State* L );
+	
+	//----------------------------------------------------------------//
+	void			ClearBakedAnimations		();
+	void			ClearBoneSamples			();
+	void			SetMix						( cc8* fromName, cc8* toName, float duration );
 
 protected:
 	spSkeletonData* mSkeletonData;
 	spAtlas*		mAtlas;
+	
+	// mix durations shared by every skeleton created from this data
+	spAnimationStateData* mAnimationStateData;
 
 public:
 	
 	DECL_LUA_FACTORY ( MOAISpineSkeletonData )
 	
 	//----------------------------------------------------------------//
+	spBakedAnimation*	AffirmBakedAnimation	( spAnimation* animation );
 					MOAISpineSkeletonData		();
 					~MOAISpineSkeletonData		();
 	void			RegisterLuaClass			( MOAILuaState& state );
 	void			RegisterLuaFuncs			( MOAILuaState& state );
+	const MOAISpineBoneSample&	SampleBone		( spAnimation* animation, float time, bool loop, int boneIndex );
 };
 
 #endif
@@ -0,0 +1,60 @@
+/* Shared by the test programs: the extension functions spine-c needs, with no renderer behind them, and loading of the sample
+ * data. Included by exactly one file per program. Run from the spine-c directory so the data paths resolve. */
+
+#ifndef SPINE_EXAMPLE_TEST_H_
+#define SPINE_EXAMPLE_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <spine/spine.h>
+#include <spine/extension.h>
+
+void _spAtlasPage_createTexture (spAtlasPage* self, const char* path) {
+	self->rendererObject = 0;
+	self->width = 1024;
+	self->height = 1024;
+}
+
+void _spAtlasPage_disposeTexture (spAtlasPage* self) {
+}
+
+char* _spUtil_readFile (const char* path, int* length) {
+	return _readFile(path, length);
+}
+
+typedef struct {
+	spAtlas* atlas;
+	spSkeletonJson* json;
+	spSkeletonData* skeletonData;
+} TestData;
+
+/* Loads data/<name>.atlas and data/<name>.json, exiting on failure. */
+static TestData loadTestData (const char* name) {
+	TestData data;
+	char path[256];
+
+	sprintf(path, "data/%s.atlas", name);
+	data.atlas = spAtlas_readAtlasFile(path);
+	if (!data.atlas) {
+		printf("Error: Atlas not found: %s\n", path);
+		exit(1);
+	}
+
+	sprintf(path, "data/%s.json", name);
+	data.json = spSkeletonJson_create(data.atlas);
+	data.skeletonData = spSkeletonJson_readSkeletonDataFile(data.json, path);
+	if (!data.skeletonData) {
+		printf("Error: %s\n", data.json->error);
+		exit(1);
+	}
+	return data;
+}
+
+static void disposeTestData (TestData* data) {
+	spSkeletonData_dispose(data->skeletonData);
+	spSkeletonJson_dispose(data->json);
+	spAtlas_dispose(data->atlas);
+}
+
+#endif /* SPINE_EXAMPLE_TEST_H_ */
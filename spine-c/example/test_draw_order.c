@@ -0,0 +1,50 @@
+/* Resetting the draw order to setup order must restore every entry. Both resets copy slot pointers, which are wider than an
+ * int on 64-bit builds, so a copy sized by int restores only the first half. */
+
+#include "test.h"
+
+static void reverseDrawOrder (spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < skeleton->slotCount; ++i)
+		skeleton->drawOrder[i] = skeleton->slots[skeleton->slotCount - 1 - i];
+}
+
+static int checkSetupOrder (const char* name, const spSkeleton* skeleton) {
+	int i, wrong = 0;
+	for (i = 0; i < skeleton->slotCount; ++i)
+		if (skeleton->drawOrder[i] != skeleton->slots[i]) wrong++;
+	printf("%s: %d of %d entries wrong\n", name, wrong, skeleton->slotCount);
+	return wrong != 0;
+}
+
+int main (void) {
+	TestData data = loadTestData("spineboy");
+	spSkeleton* skeleton = spSkeleton_create(data.skeletonData);
+	spDrawOrderTimeline* timeline = spDrawOrderTimeline_create(2, skeleton->slotCount);
+	int* reversed = MALLOC(int, skeleton->slotCount);
+	int i, failed = 0;
+
+	reverseDrawOrder(skeleton);
+	spSkeleton_setSlotsToSetupPose(skeleton);
+	failed |= checkSetupOrder("setSlotsToSetupPose", skeleton);
+
+	/* A frame with draw order offsets, then a frame without any, which resets to setup order. */
+	for (i = 0; i < skeleton->slotCount; ++i)
+		reversed[i] = skeleton->slotCount - 1 - i;
+	spDrawOrderTimeline_setFrame(timeline, 0, 0, reversed);
+	spDrawOrderTimeline_setFrame(timeline, 1, 1, 0);
+
+	spTimeline_apply(SUPER(timeline), skeleton, 0, 0.5f, 0, 0, 1);
+	if (skeleton->drawOrder[0] != skeleton->slots[skeleton->slotCount - 1]) {
+		printf("draw order timeline: frame with offsets not applied\n");
+		failed = 1;
+	}
+	spTimeline_apply(SUPER(timeline), skeleton, 0.5f, 1.5f, 0, 0, 1);
+	failed |= checkSetupOrder("draw order timeline", skeleton);
+
+	FREE(reversed);
+	spTimeline_dispose(SUPER(timeline));
+	spSkeleton_dispose(skeleton);
+	disposeTestData(&data);
+	return failed;
+}
@@ -0,0 +1,123 @@
+/* spRegionAttachment_splitRuns, which MOAISpineSkeleton::UpdateRuns calls, must cover every quad in draw order with runs
+ * whose quads share their atlas page and blend mode, and neighbouring runs must differ in one of them. Setting the texture
+ * and blend mode once per run must then draw the same quads in the same order with no more device draws than setting them
+ * per slot. A recording stand-in for the gfx device counts state calls and the flushes a buffering device would do, on the
+ * sample data. */
+
+#include "test.h"
+
+#define MAX_QUADS 256
+
+typedef struct {
+	int textureCalls, blendCalls, penCalls, draws, quadCount;
+	const void* texture;
+	int additive;
+	const spSlot* quads[MAX_QUADS];
+} Recorder;
+
+static void recorderInit (Recorder* self) {
+	memset(self, 0, sizeof(Recorder));
+	self->additive = -1;
+}
+
+/* A buffering device flushes its pending quads when the texture or blend mode changes. */
+static void recorderSetTexture (Recorder* self, const void* texture) {
+	self->textureCalls++;
+	if (texture != self->texture) {
+		self->draws++;
+		self->texture = texture;
+	}
+}
+
+static void recorderSetBlend (Recorder* self, int additive) {
+	self->blendCalls++;
+	if (additive != self->additive) {
+		self->draws++;
+		self->additive = additive;
+	}
+}
+
+static void recorderDrawQuad (Recorder* self, const spSlot* slot) {
+	if (self->quadCount < MAX_QUADS) self->quads[self->quadCount] = slot;
+	self->quadCount++;
+}
+
+static spAtlasPage* getPage (const spRegionAttachment* attachment) {
+	return ((spAtlasRegion*)attachment->rendererObject)->page;
+}
+
+static int check (const char* name, spSkeleton* skeleton) {
+	Recorder perSlot, batched;
+	spSlot** slots = MALLOC(spSlot*, skeleton->slotCount);
+	spRegionAttachment** attachments = MALLOC(spRegionAttachment*, skeleton->slotCount);
+	spRegionRun* runs = MALLOC(spRegionRun, skeleton->slotCount);
+	int count = 0, runCount, i, ii, failed = 0;
+
+	recorderInit(&perSlot);
+	recorderInit(&batched);
+
+	for (i = 0; i < skeleton->slotCount; ++i) {
+		spSlot* slot = skeleton->drawOrder[i];
+		if (!slot->attachment || slot->attachment->type != ATTACHMENT_REGION) continue;
+		slots[count] = slot;
+		attachments[count++] = SUB_CAST(spRegionAttachment, slot->attachment);
+
+		recorderSetTexture(&perSlot, getPage(SUB_CAST(spRegionAttachment, slot->attachment)));
+		recorderSetBlend(&perSlot, slot->data->additiveBlending);
+		perSlot.penCalls++;
+		recorderDrawQuad(&perSlot, slot);
+	}
+
+	runCount = spRegionAttachment_splitRuns(slots, attachments, count, runs);
+
+	for (i = 0; i < runCount; ++i) {
+		const spRegionRun* run = runs + i;
+		if (run->count <= 0 || run->start != (i ? runs[i - 1].start + runs[i - 1].count : 0)) failed = 1;
+		if (i && run->page == runs[i - 1].page && run->additive == runs[i - 1].additive) failed = 1;
+
+		/* Colors are packed into the vertices, so runs set no pen color; neighbouring runs only set what changed. */
+		if (i == 0 || run->page != runs[i - 1].page) recorderSetTexture(&batched, run->page);
+		if (i == 0 || run->additive != runs[i - 1].additive) recorderSetBlend(&batched, run->additive);
+		for (ii = run->start; ii < run->start + run->count && ii < count; ++ii) {
+			if (getPage(attachments[ii]) != run->page || (slots[ii]->data->additiveBlending != 0) != run->additive) failed = 1;
+			recorderDrawQuad(&batched, slots[ii]);
+		}
+	}
+	if (runCount && runs[runCount - 1].start + runs[runCount - 1].count != count) failed = 1;
+
+	failed |= batched.quadCount != perSlot.quadCount || batched.draws > perSlot.draws || batched.penCalls
+			|| batched.textureCalls + batched.blendCalls > runCount * 2;
+	for (i = 0; i < perSlot.quadCount && i < MAX_QUADS; ++i)
+		if (batched.quads[i] != perSlot.quads[i]) failed = 1;
+
+	printf("%s: per slot %d texture, %d blend, %d pen calls, %d draws; %d runs: %d texture, %d blend, %d pen calls, %d draws; "
+			"%d quads\n", name, perSlot.textureCalls, perSlot.blendCalls, perSlot.penCalls, perSlot.draws, runCount,
+			batched.textureCalls, batched.blendCalls, batched.penCalls, batched.draws, batched.quadCount);
+
+	FREE(runs);
+	FREE(attachments);
+	FREE(slots);
+	return failed;
+}
+
+int main (void) {
+	static const char* names[2] = {"spineboy", "goblins"};
+	int i, ii, failed = 0;
+
+	for (i = 0; i < 2; ++i) {
+		TestData data = loadTestData(names[i]);
+		spSkeleton* skeleton = spSkeleton_create(data.skeletonData);
+		if (data.skeletonData->skinCount > 1) spSkeleton_setSkin(skeleton, data.skeletonData->skins[1]);
+		spSkeleton_setSlotsToSetupPose(skeleton);
+		failed |= check(names[i], skeleton);
+
+		/* A reversed draw order splits differently but must still draw the same quads. */
+		for (ii = 0; ii < skeleton->slotCount; ++ii)
+			skeleton->drawOrder[ii] = skeleton->slots[skeleton->slotCount - 1 - ii];
+		failed |= check("  reversed", skeleton);
+
+		spSkeleton_dispose(skeleton);
+		disposeTestData(&data);
+	}
+	return failed;
+}
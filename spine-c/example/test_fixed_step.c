@@ -0,0 +1,152 @@
+/* Fixed-step playback must not depend on the frame rate: spFixedStep, which MOAISpineSkeleton::StepFixed drives, has to fire
+ * the same events and reach the same poses whatever the frame times were. Drives spineboy through several frame traces and
+ * compares each against the 60 Hz one. */
+
+#include "test.h"
+
+#define FIXED_STEP (1 / 60.0f)
+#define DURATION 20.0
+#define MAX_STEPS 1300
+#define MAX_RECORDS 4096
+
+typedef struct {
+	unsigned int step;
+	int trackIndex;
+	spEventType type;
+	const char* name;
+	int intValue;
+	float floatValue;
+} Record;
+
+typedef struct {
+	Record records[MAX_RECORDS];
+	int recordCount;
+	unsigned int hashes[MAX_STEPS];
+	unsigned int stepCount;
+} Trace;
+
+static Trace traces[4];
+static Trace* currentTrace;
+
+static void listener (spAnimationState* state, int trackIndex, spEventType type, spEvent* event, int loopCount) {
+	Record* record;
+	if (currentTrace->recordCount == MAX_RECORDS) return;
+	record = currentTrace->records + currentTrace->recordCount++;
+	memset(record, 0, sizeof(Record));
+	record->step = currentTrace->stepCount;
+	record->trackIndex = trackIndex;
+	record->type = type;
+	record->name = event ? event->data->name : 0;
+	record->intValue = event ? event->intValue : loopCount;
+	record->floatValue = event ? event->floatValue : 0;
+}
+
+static unsigned int hashPose (const spSkeleton* skeleton) {
+	unsigned int hash = 2166136261u;
+	int i, ii;
+	for (i = 0; i < skeleton->boneCount; ++i) {
+		const spBone* bone = skeleton->bones[i];
+		float values[5];
+		const unsigned char* bytes = (const unsigned char*)values;
+		values[0] = bone->x;
+		values[1] = bone->y;
+		values[2] = bone->rotation;
+		values[3] = bone->scaleX;
+		values[4] = bone->scaleY;
+		for (ii = 0; ii < (int)sizeof(values); ++ii) {
+			hash ^= bytes[ii];
+			hash *= 16777619u;
+		}
+	}
+	return hash;
+}
+
+/* Frame times of the trace: 0 is 60 Hz, 1 is 144 Hz, 2 is 30 Hz and 3 jitters between 1 and 50 ms. */
+static float frameTime (int trace, unsigned int* seed) {
+	switch (trace) {
+	case 0:
+		return 1 / 60.0f;
+	case 1:
+		return 1 / 144.0f;
+	case 2:
+		return 1 / 30.0f;
+	default:
+		*seed = *seed * 1103515245u + 12345u;
+		return 0.001f + 0.049f * ((*seed >> 16) & 0x7fff) / 32767.0f;
+	}
+}
+
+static void runTrace (spSkeletonData* skeletonData, spAnimationStateData* stateData, int trace) {
+	spSkeleton* skeleton = spSkeleton_create(skeletonData);
+	spAnimationState* state = spAnimationState_create(stateData);
+	spFixedStep* fixedStep = spFixedStep_create(FIXED_STEP, skeleton->boneCount, skeleton->slotCount);
+	unsigned int seed = 1234;
+	double totalTime = 0;
+
+	currentTrace = traces + trace;
+	state->listener = listener;
+	spAnimationState_setAnimation(state, 0, skeletonData->animations[0], 1);
+
+	while (totalTime < DURATION) {
+		float delta = frameTime(trace, &seed);
+		int steps = spFixedStep_advance(fixedStep, skeleton, delta), i;
+		totalTime += delta;
+
+		for (i = 0; i < steps; ++i) {
+			unsigned int stepIndex = ++currentTrace->stepCount;
+
+			/* Gameplay switches animations on fixed ticks. */
+			if (stepIndex % 400 == 0)
+				spAnimationState_setAnimation(state, 0, skeletonData->animations[(stepIndex / 400) % skeletonData->animationCount], 1);
+			if (stepIndex % 650 == 0) spAnimationState_addAnimation(state, 1, skeletonData->animations[1], 0, 0);
+
+			spFixedStep_step(fixedStep, skeleton, state, 1);
+			if (stepIndex < MAX_STEPS) currentTrace->hashes[stepIndex] = hashPose(skeleton);
+		}
+
+		spFixedStep_interpolate(fixedStep, skeleton);
+	}
+
+	spFixedStep_dispose(fixedStep);
+	spAnimationState_dispose(state);
+	spSkeleton_dispose(skeleton);
+}
+
+int main (void) {
+	static const char* names[4] = {"60 Hz", "144 Hz", "30 Hz", "1-50 ms"};
+	TestData data = loadTestData("spineboy");
+	spAnimationStateData* stateData = spAnimationStateData_create(data.skeletonData);
+	int trace, i, failed = 0;
+
+	stateData->defaultMix = 0.25f;
+	for (trace = 0; trace < 4; ++trace)
+		runTrace(data.skeletonData, stateData, trace);
+
+	for (trace = 1; trace < 4; ++trace) {
+		const Trace* a = traces;
+		const Trace* b = traces + trace;
+		/* The traces end at slightly different times, so only the steps both reached are compared. */
+		unsigned int steps = a->stepCount < b->stepCount ? a->stepCount : b->stepCount;
+		int events = 0, eventsB = 0, eventsDiffering = 0, posesDiffering = 0;
+
+		while (events < a->recordCount && a->records[events].step < steps)
+			events++;
+		while (eventsB < b->recordCount && b->records[eventsB].step < steps)
+			eventsB++;
+		if (events != eventsB) eventsDiffering++;
+
+		for (i = 0; i < events && i < eventsB; ++i)
+			if (memcmp(a->records + i, b->records + i, sizeof(Record))) eventsDiffering++;
+
+		for (i = 1; i < (int)steps && i < MAX_STEPS; ++i)
+			if (a->hashes[i] != b->hashes[i]) posesDiffering++;
+
+		printf("%s vs %s: %d events, %d differ; %u steps, %d poses differ\n", names[trace], names[0], events,
+				eventsDiffering, steps, posesDiffering);
+		if (!events || eventsDiffering || posesDiffering) failed = 1;
+	}
+
+	spAnimationStateData_dispose(stateData);
+	disposeTestData(&data);
+	return failed;
+}
@@ -0,0 +1,54 @@
+/* Switching animations must not allocate once an animation state is warmed up: track entries come from the state's pool and
+ * the tracks array keeps its capacity through clearTracks. Counts allocations through _setMalloc. */
+
+#include "test.h"
+
+static long allocations;
+
+static void* countingMalloc (size_t size) {
+	allocations++;
+	return malloc(size);
+}
+
+static void switchAnimations (spAnimationState* state, spSkeleton* skeleton, spSkeletonData* skeletonData, int rounds) {
+	int i;
+	for (i = 0; i < rounds; ++i) {
+		int trackIndex = i % 4;
+		spAnimationState_setAnimation(state, trackIndex, skeletonData->animations[i % skeletonData->animationCount], 1);
+		spAnimationState_addAnimation(state, trackIndex, skeletonData->animations[0], 0, 0.1f);
+		spAnimationState_update(state, 0.05f);
+		spAnimationState_apply(state, skeleton);
+		if (i % 1000 == 999) spAnimationState_clearTracks(state);
+	}
+}
+
+int main (void) {
+	TestData data = loadTestData("spineboy");
+	spSkeleton* skeleton = spSkeleton_create(data.skeletonData);
+	spAnimationStateData* stateData = spAnimationStateData_create(data.skeletonData);
+	int poseBlending, failed = 0;
+
+	stateData->defaultMix = 0.2f;
+
+	for (poseBlending = 0; poseBlending < 2; ++poseBlending) {
+		spAnimationState* state = spAnimationState_create(stateData);
+		state->poseBlending = poseBlending;
+
+		switchAnimations(state, skeleton, data.skeletonData, 1000);
+
+		allocations = 0;
+		_setMalloc(countingMalloc);
+		switchAnimations(state, skeleton, data.skeletonData, 20000);
+		_setMalloc(malloc);
+
+		printf("poseBlending %d: %ld allocations over 20000 switches\n", poseBlending, allocations);
+		if (allocations) failed = 1;
+
+		spAnimationState_dispose(state);
+	}
+
+	spAnimationStateData_dispose(stateData);
+	spSkeleton_dispose(skeleton);
+	disposeTestData(&data);
+	return failed;
+}
@@ -0,0 +1,125 @@
+/* spRegionAttachment_computeWorldVerticesBatch must match spRegionAttachment_computeWorldVertices per slot, with the bounds
+ * it reduces matching the extremes of the vertices, and must leave the vertices unchanged when it skips the reduction. It
+ * must read the attachments it is given rather than the slots' current ones. Also times the batch, with and without bounds,
+ * against the per-slot function over posed sample data. */
+
+#include "test.h"
+#include <float.h>
+#include <time.h>
+
+#define SKELETONS 64
+#define ROUNDS 5000
+
+static double seconds (void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static int gatherRegionSlots (spSkeleton* skeleton, spSlot** slots, spRegionAttachment** attachments) {
+	int i, count = 0;
+	for (i = 0; i < skeleton->slotCount; ++i) {
+		spSlot* slot = skeleton->drawOrder[i];
+		if (!slot->attachment || slot->attachment->type != ATTACHMENT_REGION) continue;
+		slots[count] = slot;
+		attachments[count++] = SUB_CAST(spRegionAttachment, slot->attachment);
+	}
+	return count;
+}
+
+static int run (const char* name, const char* skinName, const char* animationName) {
+	TestData data = loadTestData(name);
+	spAnimation* animation = spSkeletonData_findAnimation(data.skeletonData, animationName);
+	spSkeleton* skeletons[SKELETONS];
+	spSlot** slots;
+	spRegionAttachment** attachments;
+	float *reference, *batched, *unbounded;
+	float expected[4] = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+	float bounds[4] = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX};
+	int i, ii, count = 0, failed = 0;
+	double start, perSlotTime, batchTime, unboundedTime;
+	volatile float sink = 0;
+
+	slots = MALLOC(spSlot*, SKELETONS * data.skeletonData->slotCount);
+	attachments = MALLOC(spRegionAttachment*, SKELETONS * data.skeletonData->slotCount);
+
+	/* Skeletons at different times of the animation, so the bone matrices differ. */
+	for (i = 0; i < SKELETONS; ++i) {
+		skeletons[i] = spSkeleton_create(data.skeletonData);
+		if (skinName) spSkeleton_setSkinByName(skeletons[i], skinName);
+		spSkeleton_setSlotsToSetupPose(skeletons[i]);
+		spAnimation_apply(animation, skeletons[i], 0, animation->duration * i / SKELETONS, 1, 0, 0);
+		skeletons[i]->flipX = i & 1;
+		spSkeleton_updateWorldTransform(skeletons[i]);
+		count += gatherRegionSlots(skeletons[i], slots + count, attachments + count);
+	}
+
+	reference = MALLOC(float, count * 8);
+	batched = MALLOC(float, count * 8);
+	unbounded = MALLOC(float, count * 8);
+
+	for (i = 0; i < count; ++i) {
+		spRegionAttachment_computeWorldVertices(attachments[i], 10, 20, slots[i]->bone, reference + i * 8);
+		for (ii = 0; ii < 8; ii += 2) {
+			float x = reference[i * 8 + ii], y = reference[i * 8 + ii + 1];
+			if (x < expected[0]) expected[0] = x;
+			if (y < expected[1]) expected[1] = y;
+			if (x > expected[2]) expected[2] = x;
+			if (y > expected[3]) expected[3] = y;
+		}
+	}
+
+	/* A renderer draws the attachments it captured, so the slots' attachments changing afterwards must not matter. */
+	for (i = 0; i < count; i += 2)
+		spSlot_setAttachment(slots[i], 0);
+
+	spRegionAttachment_computeWorldVerticesBatch(slots, attachments, count, 10, 20, batched, bounds);
+	spRegionAttachment_computeWorldVerticesBatch(slots, attachments, count, 10, 20, unbounded, 0);
+
+	if (memcmp(reference, batched, count * 8 * sizeof(float))) failed = 1;
+	if (memcmp(reference, unbounded, count * 8 * sizeof(float))) failed = 1;
+	if (memcmp(expected, bounds, sizeof(bounds))) failed = 1;
+
+	start = seconds();
+	for (i = 0; i < ROUNDS; ++i) {
+		for (ii = 0; ii < count; ++ii)
+			spRegionAttachment_computeWorldVertices(attachments[ii], 10, 20, slots[ii]->bone, reference + ii * 8);
+		sink += reference[i % (count * 8)];
+	}
+	perSlotTime = seconds() - start;
+
+	start = seconds();
+	for (i = 0; i < ROUNDS; ++i) {
+		bounds[0] = bounds[1] = FLT_MAX;
+		bounds[2] = bounds[3] = -FLT_MAX;
+		spRegionAttachment_computeWorldVerticesBatch(slots, attachments, count, 10, 20, batched, bounds);
+		sink += bounds[0];
+	}
+	batchTime = seconds() - start;
+
+	start = seconds();
+	for (i = 0; i < ROUNDS; ++i) {
+		spRegionAttachment_computeWorldVerticesBatch(slots, attachments, count, 10, 20, unbounded, 0);
+		sink += unbounded[i % (count * 8)];
+	}
+	unboundedTime = seconds() - start;
+
+	printf("%s/%s: %d slots, %s; ns per slot: per-slot function %.2f, batch with bounds %.2f, "
+			"batch without bounds %.2f\n", name, animationName, count, failed ? "MISMATCH" : "identical", perSlotTime * 1e9 / ROUNDS / count,
+			batchTime * 1e9 / ROUNDS / count, unboundedTime * 1e9 / ROUNDS / count);
+
+	FREE(unbounded);
+	FREE(batched);
+	FREE(reference);
+	FREE(attachments);
+	FREE(slots);
+	for (i = 0; i < SKELETONS; ++i)
+		spSkeleton_dispose(skeletons[i]);
+	disposeTestData(&data);
+	return failed;
+}
+
+int main (void) {
+	int failed = 0;
+	failed |= run("spineboy", 0, "walk");
+	failed |= run("goblins", "goblin", "walk");
+	return failed;
+}
@@ -67,20 +67,51 @@ void spAnimation_apply (const spAnimation* self, struct spSkeleton* skeleton, fl
 void spAnimation_mix (const spAnimation* self, struct spSkeleton* skeleton, float lastTime, float time, int loop,
 		spEvent** events, int* eventCount, float alpha);
 
+/** Same as spAnimation_mix, but only applies timelines whose type is in the mask.
+ * @param timelineMask Bits of 1 << spTimelineType, see TIMELINE_MASK_POSE and TIMELINE_MASK_CHANGES. Quantized timelines
+ * are masked by the type they were created from. */
+void spAnimation_mixTimelines (const spAnimation* self, struct spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventCount, float alpha, int timelineMask);
+
+/** Replaces the rotate, translate, scale and color timelines with quantized timelines, which use far less memory and are
+ * decoded as they are applied.
+ * @param tolerance The maximum error allowed when dropping keys or collapsing constant timelines, in degrees for rotation
+ * and skeleton units for translation. Scale and color use a hundredth of this. 0 only drops keys that are exactly
+ * redundant. */
+void spAnimation_compress (spAnimation* self, float tolerance);
+
+/** Returns the most events a single apply or mix of the animation can fire, for sizing the events array. */
+int spAnimation_getMaxEventCount (const spAnimation* self);
+
+/** Poses the scratch skeleton at the specified time for this animation, starting from the setup pose and without firing
+ * events. Sampling into a skeleton that isn't drawn answers queries about the animation without disturbing live skeletons.
+ * Call spSkeleton_updateWorldTransform on the scratch skeleton for world transforms. */
+void spAnimation_sample (const spAnimation* self, struct spSkeleton* scratch, float time, int/*bool*/loop);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spAnimation Animation;
 #define Animation_create(...) spAnimation_create(__VA_ARGS__)
 #define Animation_dispose(...) spAnimation_dispose(__VA_ARGS__)
 #define Animation_apply(...) spAnimation_apply(__VA_ARGS__)
 #define Animation_mix(...) spAnimation_mix(__VA_ARGS__)
+#define Animation_mixTimelines(...) spAnimation_mixTimelines(__VA_ARGS__)
+#define Animation_compress(...) spAnimation_compress(__VA_ARGS__)
+#define Animation_getMaxEventCount(...) spAnimation_getMaxEventCount(__VA_ARGS__)
+#define Animation_sample(...) spAnimation_sample(__VA_ARGS__)
 #endif
 
 /**/
 
 typedef enum {
-	TIMELINE_SCALE, TIMELINE_ROTATE, TIMELINE_TRANLATE, TIMELINE_COLOR, TIMELINE_ATTACHMENT, TIMELINE_EVENT, TIMELINE_DRAWORDER
+	TIMELINE_SCALE, TIMELINE_ROTATE, TIMELINE_TRANLATE, TIMELINE_COLOR, TIMELINE_ATTACHMENT, TIMELINE_EVENT, TIMELINE_DRAWORDER,
+	TIMELINE_QUANTIZED
 } spTimelineType;
 
+/* Timelines that pose bones and slot colors, and timelines that switch attachments and draw order or fire events. */
+#define TIMELINE_MASK_POSE ((1 << TIMELINE_SCALE) | (1 << TIMELINE_ROTATE) | (1 << TIMELINE_TRANLATE) | (1 << TIMELINE_COLOR))
+#define TIMELINE_MASK_CHANGES ((1 << TIMELINE_ATTACHMENT) | (1 << TIMELINE_EVENT) | (1 << TIMELINE_DRAWORDER))
+#define TIMELINE_MASK_ALL (TIMELINE_MASK_POSE | TIMELINE_MASK_CHANGES)
+
 struct spTimeline {
 	const spTimelineType type;
 
@@ -247,6 +278,32 @@ typedef spDrawOrderTimeline DrawOrderTimeline;
 #define DrawOrderTimeline_setFrame(...) spDrawOrderTimeline_setFrame(__VA_ARGS__)
 #endif
 
+/**/
+
+typedef struct {
+	spTimeline super;
+	spTimelineType const sourceType; /* TIMELINE_ROTATE, TIMELINE_TRANLATE, TIMELINE_SCALE or TIMELINE_COLOR. */
+	int const frameCount;
+	int const channelCount;
+	float* const times;
+	unsigned short* const values; /* channelCount values per frame, each decoded as offsets[c] + value * scales[c]. */
+	float* const offsets;
+	float* const scales;
+	unsigned short* const curveIndices; /* Per frame but the last: 0 linear, 1 stepped, n bezier at curves[(n - 2) * 6]. */
+	int const curveCount;
+	float* const curves; /* dfx, dfy, ddfx, ddfy, dddfx, dddfy, ... */
+	int index; /* Bone index, or slot index for color. */
+} spQuantizedTimeline;
+
+/* Returns 0 if the source timeline can't be quantized.
+ * @param tolerance See spAnimation_compress. */
+spQuantizedTimeline* spQuantizedTimeline_create (const spTimeline* source, float tolerance);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spQuantizedTimeline QuantizedTimeline;
+#define QuantizedTimeline_create(...) spQuantizedTimeline_create(__VA_ARGS__)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,10 @@ typedef struct spAnimationState spAnimationState;
 typedef void (*spAnimationStateListener) (spAnimationState* state, int trackIndex, spEventType type, spEvent* event,
 		int loopCount);
 
+/** Poses the skeleton for an animation. Same semantics as spAnimation_mix, which is used when the state has no mixer. */
+typedef void (*spAnimationStateMixer) (spAnimationState* state, spAnimation* animation, struct spSkeleton* skeleton,
+		float lastTime, float time, int loop, spEvent** events, int* eventCount, float alpha);
+
 typedef struct spTrackEntry spTrackEntry;
 struct spTrackEntry {
 	spTrackEntry* next;
@@ -66,8 +70,18 @@ struct spAnimationState {
 	spAnimationStateData* const data;
 	float timeScale;
 	spAnimationStateListener listener;
+	spAnimationStateMixer mixer;
 	void* context;
 
+	/* When set, setting an animation during a mix chains the mixes instead of dropping the entry being mixed out. A chain is
+	 * blended by sampling each animation into a pose buffer and writing the skeleton once; a mix from a single entry is still
+	 * applied in place, which is faster. Off by default. */
+	int/*bool*/poseBlending;
+
+	/* Timelines applied when posing, as bits of 1 << spTimelineType. TIMELINE_MASK_ALL by default; clearing bits such as
+	 * 1 << TIMELINE_COLOR skips low priority timelines. Mixers are not masked. */
+	int timelineMask;
+
 	int trackCount;
 	spTrackEntry** tracks;
 };
@@ -78,6 +92,9 @@ void spAnimationState_dispose (spAnimationState* self);
 
 void spAnimationState_update (spAnimationState* self, float delta);
 void spAnimationState_apply (spAnimationState* self, struct spSkeleton* skeleton);
+/** Fires the events and completions apply would, without posing the skeleton. Keeps the tracks in step for skeletons that
+ * aren't drawn. */
+void spAnimationState_applyEvents (spAnimationState* self, struct spSkeleton* skeleton);
 
 void spAnimationState_clearTracks (spAnimationState* self);
 void spAnimationState_clearTrack (spAnimationState* self, int trackIndex);
@@ -96,15 +113,21 @@ spTrackEntry* spAnimationState_addAnimation (spAnimationState* self, int trackIn
 
 spTrackEntry* spAnimationState_getCurrent (spAnimationState* self, int trackIndex);
 
+/** Replaces the tracks with copies of the other state's, including queued entries and entries being mixed out. No listeners
+ * are notified; the copied entries keep the other state's entry listeners. */
+void spAnimationState_copyTracks (spAnimationState* self, const spAnimationState* other);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spEventType EventType;
 typedef spAnimationStateListener AnimationStateListener;
+typedef spAnimationStateMixer AnimationStateMixer;
 typedef spTrackEntry TrackEntry;
 typedef spAnimationState AnimationState;
 #define AnimationState_create(...) spAnimationState_create(__VA_ARGS__)
 #define AnimationState_dispose(...) spAnimationState_dispose(__VA_ARGS__)
 #define AnimationState_update(...) spAnimationState_update(__VA_ARGS__)
 #define AnimationState_apply(...) spAnimationState_apply(__VA_ARGS__)
+#define AnimationState_applyEvents(...) spAnimationState_applyEvents(__VA_ARGS__)
 #define AnimationState_clearTracks(...) spAnimationState_clearTracks(__VA_ARGS__)
 #define AnimationState_clearTrack(...) spAnimationState_clearTrack(__VA_ARGS__)
 #define AnimationState_setAnimationByName(...) spAnimationState_setAnimationByName(__VA_ARGS__)
@@ -112,6 +135,7 @@ typedef spAnimationState AnimationState;
 #define AnimationState_addAnimationByName(...) spAnimationState_addAnimationByName(__VA_ARGS__)
 #define AnimationState_addAnimation(...) spAnimationState_addAnimation(__VA_ARGS__)
 #define AnimationState_getCurrent(...) spAnimationState_getCurrent(__VA_ARGS__)
+#define AnimationState_copyTracks(...) spAnimationState_copyTracks(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
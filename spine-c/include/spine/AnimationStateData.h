@@ -41,23 +41,30 @@
 extern "C" {
 #endif
 
-typedef struct {
+typedef struct spAnimationStateData {
 	spSkeletonData* const skeletonData;
 	float defaultMix;
 	const void* const entries;
+	struct spAnimationStateData* const parent;
 } spAnimationStateData;
 
 spAnimationStateData* spAnimationStateData_create (spSkeletonData* skeletonData);
+/* Creates mix data for overriding some of the parent's mixes. Mixes not set on it are looked up in the parent, which must
+ * outlive it. Its defaultMix starts as the parent's and is used when neither sets a mix. */
+spAnimationStateData* spAnimationStateData_createOverride (spAnimationStateData* parent);
 void spAnimationStateData_dispose (spAnimationStateData* self);
 
-void spAnimationStateData_setMixByName (spAnimationStateData* self, const char* fromName, const char* toName, float duration);
-void spAnimationStateData_setMix (spAnimationStateData* self, spAnimation* from, spAnimation* to, float duration);
+/* Returns 0 if either animation was not found, leaving the mixes unchanged. */
+int spAnimationStateData_setMixByName (spAnimationStateData* self, const char* fromName, const char* toName, float duration);
+/* Returns 0 if either animation is 0, leaving the mixes unchanged. */
+int spAnimationStateData_setMix (spAnimationStateData* self, spAnimation* from, spAnimation* to, float duration);
 /* Returns 0 if there is no mixing between the animations. */
 float spAnimationStateData_getMix (spAnimationStateData* self, spAnimation* from, spAnimation* to);
 
 #ifdef SPINE_SHORT_NAMES
 typedef spAnimationStateData AnimationStateData;
 #define AnimationStateData_create(...) spAnimationStateData_create(__VA_ARGS__)
+#define AnimationStateData_createOverride(...) spAnimationStateData_createOverride(__VA_ARGS__)
 #define AnimationStateData_dispose(...) spAnimationStateData_dispose(__VA_ARGS__)
 #define AnimationStateData_setMixByName(...) spAnimationStateData_setMixByName(__VA_ARGS__)
 #define AnimationStateData_setMix(...) spAnimationStateData_setMix(__VA_ARGS__)
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Spine Runtime Software License - Version 1.1
+ * 
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms in whole or in part, with
+ * or without modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. A Spine Essential, Professional, Enterprise, or Education License must
+ *    be purchased from Esoteric Software and the license must remain valid:
+ *    http://esotericsoftware.com/
+ * 2. Redistributions of source code must retain this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer.
+ * 3. Redistributions in binary form must reproduce this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer, in the documentation and/or other materials provided with the
+ *    distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_BAKEDANIMATION_H_
+#define SPINE_BAKEDANIMATION_H_
+
+#include <spine/Animation.h>
+#include <spine/SkeletonData.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct spSkeleton;
+
+typedef enum {
+	BAKED_TRANSLATE = 1, BAKED_ROTATE = 2, BAKED_SCALE = 4
+} spBakedChannel;
+
+/** An animation sampled at a fixed rate. Bone and slot color timelines are replaced by a table of local poses that is linearly
+ * interpolated at playback, trading keyframe accurate curves for a constant cost lookup. Attachment, draw order and event
+ * timelines are already keyed change lists and are applied from the source animation unchanged. */
+typedef struct {
+	const spAnimation* const animation;
+	float const rate;
+	int const frameCount;
+
+	int const boneCount;
+	const int* const boneIndices;
+	const int* const boneChannels; /* spBakedChannel flags of the channels keyed for each bone. */
+	const float* const boneStarts; /* First key time of the translate, rotate and scale channels of each bone. */
+	const float* const bones; /* x, y, rotation, scaleX, scaleY for each bone, for each frame. */
+
+	int const slotCount;
+	const int* const slotIndices;
+	const float* const slotStarts; /* First key time of the color of each slot. */
+	const float* const slots; /* r, g, b, a for each slot, for each frame. */
+
+	int const changeCount;
+	spTimeline** const changes; /* Attachment, draw order and event timelines, owned by the source animation. */
+} spBakedAnimation;
+
+/* @param rate Samples per second. */
+spBakedAnimation* spBakedAnimation_create (const spAnimation* animation, spSkeletonData* skeletonData, float rate);
+void spBakedAnimation_dispose (spBakedAnimation* self);
+
+/** Poses the skeleton at the specified time, mixed with the current pose. Same semantics as spAnimation_mix: channels are
+ * left untouched before their first key, as the timelines they were sampled from leave them. */
+void spBakedAnimation_apply (const spBakedAnimation* self, struct spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventCount, float alpha);
+
+/** Returns the number of bytes used by the sampled tables. */
+int spBakedAnimation_getSize (const spBakedAnimation* self);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spBakedChannel BakedChannel;
+typedef spBakedAnimation BakedAnimation;
+#define BakedAnimation_create(...) spBakedAnimation_create(__VA_ARGS__)
+#define BakedAnimation_dispose(...) spBakedAnimation_dispose(__VA_ARGS__)
+#define BakedAnimation_apply(...) spBakedAnimation_apply(__VA_ARGS__)
+#define BakedAnimation_getSize(...) spBakedAnimation_getSize(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_BAKEDANIMATION_H_ */
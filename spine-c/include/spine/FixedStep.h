@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Spine Runtime Software License - Version 1.1
+ * 
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms in whole or in part, with
+ * or without modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. A Spine Essential, Professional, Enterprise, or Education License must
+ *    be purchased from Esoteric Software and the license must remain valid:
+ *    http://esotericsoftware.com/
+ * 2. Redistributions of source code must retain this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer.
+ * 3. Redistributions in binary form must reproduce this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer, in the documentation and/or other materials provided with the
+ *    distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+
+#ifndef SPINE_FIXEDSTEP_H_
+#define SPINE_FIXEDSTEP_H_
+
+#include <spine/AnimationState.h>
+#include <spine/SkeletonPose.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct spSkeleton;
+
+/** Advances a skeleton and its animation state in fixed steps whatever the frame times are, so the same total time always gives
+ * the same poses and events. The drawn pose is interpolated between the last two steps and so lags by up to one step. Per
+ * frame: call spFixedStep_advance, then spFixedStep_step as many times as it returns, then spFixedStep_interpolate. */
+typedef struct {
+	float const step;
+	double time; /* Time not yet stepped, less than step once advanced. */
+	int/*bool*/sampled; /* Set once poses hold a step. Clear it to start again from the skeleton's pose. */
+	spSkeletonPose* const poses[3]; /* The second last and last step, and their blend. */
+} spFixedStep;
+
+spFixedStep* spFixedStep_create (float step, int boneCount, int slotCount);
+void spFixedStep_dispose (spFixedStep* self);
+
+/** Adds the frame time and returns how many whole steps are due. When any are, the skeleton is set back to the last step's
+ * pose so the steps continue from it rather than from the interpolated pose. */
+int spFixedStep_advance (spFixedStep* self, struct spSkeleton* skeleton, float delta);
+
+/** Updates the skeleton and state by one step. When posing, applies the state and captures the pose; otherwise only fires
+ * the state's events, as for a skeleton that isn't drawn.
+ * @param state May be 0. */
+void spFixedStep_step (spFixedStep* self, struct spSkeleton* skeleton, spAnimationState* state, int/*bool*/pose);
+
+/** Poses the skeleton between the last two steps by the time not yet stepped. Returns 0, leaving the skeleton alone, when no
+ * step has been captured. */
+int/*bool*/spFixedStep_interpolate (spFixedStep* self, struct spSkeleton* skeleton);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spFixedStep FixedStep;
+#define FixedStep_create(...) spFixedStep_create(__VA_ARGS__)
+#define FixedStep_dispose(...) spFixedStep_dispose(__VA_ARGS__)
+#define FixedStep_advance(...) spFixedStep_advance(__VA_ARGS__)
+#define FixedStep_step(...) spFixedStep_step(__VA_ARGS__)
+#define FixedStep_interpolate(...) spFixedStep_interpolate(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_FIXEDSTEP_H_ */
@@ -65,13 +65,44 @@ void spRegionAttachment_setUVs (spRegionAttachment* self, float u, float v, floa
 void spRegionAttachment_updateOffset (spRegionAttachment* self);
 void spRegionAttachment_computeWorldVertices (spRegionAttachment* self, float x, float y, spBone* bone, float* vertices);
 
+/** Computes the world vertices of region attachments on many slots in one pass and grows the bounds to contain them.
+ * Uses SSE or NEON when the compiler targets them, unless SPINE_NO_SIMD is defined.
+ * @param slots Slots whose bones place the attachments.
+ * @param attachments The region attachment drawn on each slot. A renderer that captured the attachments when it posed passes
+ *           those, so the vertices match the UVs it draws even if a slot's attachment has changed since.
+ * @param vertices 8 floats per slot, in spVertexIndex order.
+ * @param bounds minX, minY, maxX, maxY. Start from FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX for the bounds of these slots only.
+ *           May be 0 to skip the reduction when the caller has its bounds from elsewhere. */
+void spRegionAttachment_computeWorldVerticesBatch (spSlot** slots, spRegionAttachment** attachments, int count, float x, float y,
+		float* vertices, float* bounds);
+
+/* Consecutive quads in draw order that share an atlas page and blend mode. */
+typedef struct spRegionRun spRegionRun;
+struct spRegionRun {
+	spAtlasPage* page;
+	int/*bool*/additive;
+	int start; /* First quad of the run. */
+	int count;
+};
+
+/** Splits quads into runs that share an atlas page and blend mode, so a renderer sets its texture and blend mode once per run.
+ * Neighbouring runs differ in page or blend mode, or both.
+ * @param slots The slot of each quad, in draw order. Its data gives the blend mode.
+ * @param attachments The region attachment of each quad, loaded by spAtlasAttachmentLoader.
+ * @param runs Room for count runs.
+ * @return The number of runs. */
+int spRegionAttachment_splitRuns (spSlot** slots, spRegionAttachment** attachments, int count, spRegionRun* runs);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spVertexIndex VertexIndex;
 typedef spRegionAttachment RegionAttachment;
+typedef spRegionRun RegionRun;
 #define RegionAttachment_create(...) spRegionAttachment_create(__VA_ARGS__)
 #define RegionAttachment_setUVs(...) spRegionAttachment_setUVs(__VA_ARGS__)
 #define RegionAttachment_updateOffset(...) spRegionAttachment_updateOffset(__VA_ARGS__)
 #define RegionAttachment_computeWorldVertices(...) spRegionAttachment_computeWorldVertices(__VA_ARGS__)
+#define RegionAttachment_computeWorldVerticesBatch(...) spRegionAttachment_computeWorldVerticesBatch(__VA_ARGS__)
+#define RegionAttachment_splitRuns(...) spRegionAttachment_splitRuns(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
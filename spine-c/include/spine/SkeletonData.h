@@ -60,6 +60,12 @@ typedef struct {
 
 	int animationCount;
 	spAnimation** animations;
+
+	/* Set by spSkeletonData_computeAnimationBounds: for each animation, a minX, minY, maxX, maxY box per boundsSegment
+	 * seconds of it, or one box when boundsSegment is 0. */
+	float boundsSegment;
+	int* animationBoundsCounts;
+	float** animationBounds;
 } spSkeletonData;
 
 spSkeletonData* spSkeletonData_create ();
@@ -77,6 +83,19 @@ spEventData* spSkeletonData_findEvent (const spSkeletonData* self, const char* e
 
 spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const char* animationName);
 
+/** Samples every animation and stores boxes containing every region attachment any skin can put on any slot, so the bounds
+ * of an animated skeleton can be had without posing it. Each box is padded by the most an edge moved between two of its
+ * samples, to cover the motion between them.
+ * @param sampleRate Samples per second.
+ * @param segmentDuration Seconds covered by each box, or 0 for one box per animation. */
+void spSkeletonData_computeAnimationBounds (spSkeletonData* self, float sampleRate, float segmentDuration);
+
+/** Grows the bounds by the box of the animation at the specified time, unflipped and relative to the skeleton's position.
+ * @param bounds minX, minY, maxX, maxY.
+ * @return 0 if the animation has no computed bounds. */
+int/*bool*/spSkeletonData_growAnimationBounds (const spSkeletonData* self, const spAnimation* animation, float time,
+		int/*bool*/loop, float* bounds);
+
 #ifdef SPINE_SHORT_NAMES
 typedef spSkeletonData SkeletonData;
 #define SkeletonData_create(...) spSkeletonData_create(__VA_ARGS__)
@@ -88,6 +107,8 @@ typedef spSkeletonData SkeletonData;
 #define SkeletonData_findSkin(...) spSkeletonData_findSkin(__VA_ARGS__)
 #define SkeletonData_findEvent(...) spSkeletonData_findEvent(__VA_ARGS__)
 #define SkeletonData_findAnimation(...) spSkeletonData_findAnimation(__VA_ARGS__)
+#define SkeletonData_computeAnimationBounds(...) spSkeletonData_computeAnimationBounds(__VA_ARGS__)
+#define SkeletonData_growAnimationBounds(...) spSkeletonData_growAnimationBounds(__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Spine Runtime Software License - Version 1.1
+ * 
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms in whole or in part, with
+ * or without modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. A Spine Essential, Professional, Enterprise, or Education License must
+ *    be purchased from Esoteric Software and the license must remain valid:
+ *    http://esotericsoftware.com/
+ * 2. Redistributions of source code must retain this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer.
+ * 3. Redistributions in binary form must reproduce this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer, in the documentation and/or other materials provided with the
+ *    distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONPOSE_H_
+#define SPINE_SKELETONPOSE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct spSkeleton;
+
+/** Local bone transforms and slot colors of a skeleton, stored as one array per channel so poses can be blended in a single
+ * pass over contiguous floats. */
+typedef struct {
+	int const boneCount;
+	float* const x;
+	float* const y;
+	float* const rotation;
+	float* const scaleX;
+	float* const scaleY;
+
+	int const slotCount;
+	float* const r;
+	float* const g;
+	float* const b;
+	float* const a;
+} spSkeletonPose;
+
+spSkeletonPose* spSkeletonPose_create (int boneCount, int slotCount);
+void spSkeletonPose_dispose (spSkeletonPose* self);
+
+/* Copies the skeleton's local bone transforms and slot colors into the pose. */
+void spSkeletonPose_capture (spSkeletonPose* self, const struct spSkeleton* skeleton);
+/* Sets the skeleton's local bone transforms and slot colors from the pose. */
+void spSkeletonPose_restore (const spSkeletonPose* self, struct spSkeleton* skeleton);
+void spSkeletonPose_copy (spSkeletonPose* self, const spSkeletonPose* pose);
+/** Returns 1 if the skeleton's local bone transforms are exactly those in the pose. Slot colors are not compared. */
+int/*bool*/spSkeletonPose_matchesBones (const spSkeletonPose* self, const struct spSkeleton* skeleton);
+
+/** Moves this pose toward the target. Rotations take the shortest path.
+ * @param alpha 0 keeps this pose, 1 gives the target and values above 1 extrapolate past it. */
+void spSkeletonPose_blend (spSkeletonPose* self, const spSkeletonPose* target, float alpha);
+
+#ifdef SPINE_SHORT_NAMES
+typedef spSkeletonPose SkeletonPose;
+#define SkeletonPose_create(...) spSkeletonPose_create(__VA_ARGS__)
+#define SkeletonPose_dispose(...) spSkeletonPose_dispose(__VA_ARGS__)
+#define SkeletonPose_capture(...) spSkeletonPose_capture(__VA_ARGS__)
+#define SkeletonPose_restore(...) spSkeletonPose_restore(__VA_ARGS__)
+#define SkeletonPose_copy(...) spSkeletonPose_copy(__VA_ARGS__)
+#define SkeletonPose_matchesBones(...) spSkeletonPose_matchesBones(__VA_ARGS__)
+#define SkeletonPose_blend(...) spSkeletonPose_blend(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPINE_SKELETONPOSE_H_ */
@@ -138,10 +138,15 @@ void (*dispose) (spTimeline* self), /**/
 		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 				int* eventCount, float alpha));
 void _spTimeline_deinit (spTimeline* self);
+/* Replaces the apply function of one timeline. Timelines of a type share their vtable, so it is copied for this one first. */
+void _spTimeline_setApply (spTimeline* self, /**/
+		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+				int* eventCount, float alpha));
 
 #ifdef SPINE_SHORT_NAMES
 #define _Timeline_init(...) _spTimeline_init(__VA_ARGS__)
 #define _Timeline_deinit(...) _spTimeline_deinit(__VA_ARGS__)
+#define _Timeline_setApply(...) _spTimeline_setApply(__VA_ARGS__)
 #endif
 
 /**/
@@ -41,6 +41,7 @@
 #include <spine/AtlasAttachmentLoader.h>
 #include <spine/Attachment.h>
 #include <spine/AttachmentLoader.h>
+#include <spine/BakedAnimation.h>
 #include <spine/Bone.h>
 #include <spine/BoneData.h>
 #include <spine/RegionAttachment.h>
@@ -49,10 +50,12 @@
 #include <spine/SkeletonBounds.h>
 #include <spine/SkeletonData.h>
 #include <spine/SkeletonJson.h>
+#include <spine/SkeletonPose.h>
 #include <spine/Skin.h>
 #include <spine/Slot.h>
 #include <spine/SlotData.h>
 #include <spine/Event.h>
 #include <spine/EventData.h>
+#include <spine/FixedStep.h>
 
 #endif /* SPINE_SPINE_H_ */
@@ -35,6 +35,11 @@
 #include <limits.h>
 #include <spine/extension.h>
 
+static int _spTimeline_getMask (const spTimeline* timeline) {
+	if (timeline->type == TIMELINE_QUANTIZED) return 1 << SUB_CAST(spQuantizedTimeline, timeline)->sourceType;
+	return 1 << timeline->type;
+}
+
 spAnimation* spAnimation_create (const char* name, int timelineCount) {
 	spAnimation* self = NEW(spAnimation);
 	MALLOC_STR(self->name, name);
@@ -54,6 +59,16 @@ void spAnimation_dispose (spAnimation* self) {
 
 void spAnimation_apply (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events,
 		int* eventCount) {
+	spAnimation_mix(self, skeleton, lastTime, time, loop, events, eventCount, 1);
+}
+
+void spAnimation_mix (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events,
+		int* eventCount, float alpha) {
+	spAnimation_mixTimelines(self, skeleton, lastTime, time, loop, events, eventCount, alpha, TIMELINE_MASK_ALL);
+}
+
+void spAnimation_mixTimelines (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventCount, float alpha, int timelineMask) {
 	int i, n = self->timelineCount;
 
 	if (loop && self->duration) {
@@ -62,42 +77,77 @@ void spAnimation_apply (const spAnimation* self, spSkeleton* skeleton, float las
 	}
 
 	for (i = 0; i < n; ++i)
-		spTimeline_apply(self->timelines[i], skeleton, lastTime, time, events, eventCount, 1);
+		if (timelineMask & _spTimeline_getMask(self->timelines[i]))
+			spTimeline_apply(self->timelines[i], skeleton, lastTime, time, events, eventCount, alpha);
 }
 
-void spAnimation_mix (const spAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop, spEvent** events,
-		int* eventCount, float alpha) {
-	int i, n = self->timelineCount;
+void spAnimation_sample (const spAnimation* self, spSkeleton* scratch, float time, int/*bool*/loop) {
+	spSkeleton_setToSetupPose(scratch);
+	spAnimation_mixTimelines(self, scratch, time, time, loop, 0, 0, 1, TIMELINE_MASK_ALL & ~(1 << TIMELINE_EVENT));
+}
 
-	if (loop && self->duration) {
-		time = FMOD(time, self->duration);
-		lastTime = FMOD(lastTime, self->duration);
+void spAnimation_compress (spAnimation* self, float tolerance) {
+	int i;
+	for (i = 0; i < self->timelineCount; ++i) {
+		spTimeline* timeline = (spTimeline*)spQuantizedTimeline_create(self->timelines[i], tolerance);
+		if (!timeline) continue;
+		spTimeline_dispose(self->timelines[i]);
+		self->timelines[i] = timeline;
 	}
+}
 
-	for (i = 0; i < n; ++i)
-		spTimeline_apply(self->timelines[i], skeleton, lastTime, time, events, eventCount, alpha);
+/* An event timeline fires each of its frames at most once per apply, even when a looped animation wraps. */
+int spAnimation_getMaxEventCount (const spAnimation* self) {
+	int i, count = 0;
+	for (i = 0; i < self->timelineCount; ++i)
+		if (self->timelines[i]->type == TIMELINE_EVENT) count += SUB_CAST(spEventTimeline, self->timelines[i])->framesLength;
+	return count;
 }
 
 /**/
 
+/* Timelines of the built in types share one static vtable per type. A timeline only gets its own copy, freed with it, when it
+ * is created through _spTimeline_init or its apply function is replaced. */
 typedef struct _spTimelineVtable {
 	void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 			int* eventCount, float alpha);
 	void (*dispose) (spTimeline* self);
+	int/*bool*/owned;
 } _spTimelineVtable;
 
+static void _spTimeline_initVtable (spTimeline* self, spTimelineType type, const _spTimelineVtable* vtable) {
+	CONST_CAST(spTimelineType, self->type) = type;
+	CONST_CAST(const _spTimelineVtable*, self->vtable) = vtable;
+}
+
+static _spTimelineVtable* _spTimeline_createVtable (void (*dispose) (spTimeline* self), /**/
+		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+				int* eventCount, float alpha)) {
+	_spTimelineVtable* vtable = NEW(_spTimelineVtable);
+	vtable->dispose = dispose;
+	vtable->apply = apply;
+	vtable->owned = 1;
+	return vtable;
+}
+
 void _spTimeline_init (spTimeline* self, spTimelineType type, /**/
 void (*dispose) (spTimeline* self), /**/
 		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
 				int* eventCount, float alpha)) {
-	CONST_CAST(spTimelineType, self->type) = type;
-	CONST_CAST(_spTimelineVtable*, self->vtable) = NEW(_spTimelineVtable);
-	VTABLE(spTimeline, self)->dispose = dispose;
-	VTABLE(spTimeline, self)->apply = apply;
+	_spTimeline_initVtable(self, type, _spTimeline_createVtable(dispose, apply));
 }
 
 void _spTimeline_deinit (spTimeline* self) {
-	FREE(self->vtable);
+	if (VTABLE(spTimeline, self)->owned) FREE(self->vtable);
+}
+
+void _spTimeline_setApply (spTimeline* self, /**/
+		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
+				int* eventCount, float alpha)) {
+	if (!VTABLE(spTimeline, self)->owned)
+		_spTimeline_initVtable(self, self->type, _spTimeline_createVtable(VTABLE(spTimeline, self)->dispose, apply));
+	else
+		VTABLE(spTimeline, self)->apply = apply;
 }
 
 void spTimeline_dispose (spTimeline* self) {
@@ -123,6 +173,12 @@ void (*dispose) (spTimeline* self), /**/
 	self->curves = CALLOC(float, (frameCount - 1) * 6);
 }
 
+static void _spCurveTimeline_initVtable (spCurveTimeline* self, spTimelineType type, int frameCount,
+		const _spTimelineVtable* vtable) {
+	_spTimeline_initVtable(SUPER(self), type, vtable);
+	self->curves = CALLOC(float, (frameCount - 1) * 6);
+}
+
 void _spCurveTimeline_deinit (spCurveTimeline* self) {
 	_spTimeline_deinit(SUPER(self));
 	FREE(self->curves);
@@ -157,7 +213,7 @@ void spCurveTimeline_setCurve (spCurveTimeline* self, int frameIndex, float cx1,
 	self->curves[i + 5] = tmp2y * pre5;
 }
 
-float spCurveTimeline_getCurvePercent (const spCurveTimeline* self, int frameIndex, float percent) {
+static float _spCurveTimeline_getCurvePercent (const float* curves, float percent) {
 	float dfy;
 	float ddfx;
 	float ddfy;
@@ -165,15 +221,14 @@ float spCurveTimeline_getCurvePercent (const spCurveTimeline* self, int frameInd
 	float dddfy;
 	float x, y;
 	int i;
-	int curveIndex = frameIndex * 6;
-	float dfx = self->curves[curveIndex];
+	float dfx = curves[0];
 	if (dfx == CURVE_LINEAR) return percent;
 	if (dfx == CURVE_STEPPED) return 0;
-	dfy = self->curves[curveIndex + 1];
-	ddfx = self->curves[curveIndex + 2];
-	ddfy = self->curves[curveIndex + 3];
-	dddfx = self->curves[curveIndex + 4];
-	dddfy = self->curves[curveIndex + 5];
+	dfy = curves[1];
+	ddfx = curves[2];
+	ddfy = curves[3];
+	dddfx = curves[4];
+	dddfy = curves[5];
 	x = dfx, y = dfy;
 	i = CURVE_SEGMENTS - 2;
 	while (1) {
@@ -194,6 +249,10 @@ float spCurveTimeline_getCurvePercent (const spCurveTimeline* self, int frameInd
 	return y + (1 - y) * (percent - x) / (1 - x); /* Last point is 1,1. */
 }
 
+float spCurveTimeline_getCurvePercent (const spCurveTimeline* self, int frameIndex, float percent) {
+	return _spCurveTimeline_getCurvePercent(self->curves + frameIndex * 6, percent);
+}
+
 /* @param target After the first and before the last entry. */
 static int binarySearch (float *values, int valuesLength, float target, int step) {
 	int low = 0, current;
@@ -230,11 +289,10 @@ void _spBaseTimeline_dispose (spTimeline* timeline) {
 }
 
 /* Many timelines have structure identical to struct spBaseTimeline and extend spCurveTimeline. **/
-struct spBaseTimeline* _spBaseTimeline_create (int frameCount, spTimelineType type, int frameSize, /**/
-		void (*apply) (const spTimeline* self, spSkeleton* skeleton, float lastTime, float time, spEvent** firedEvents,
-				int* eventCount, float alpha)) {
+struct spBaseTimeline* _spBaseTimeline_create (int frameCount, spTimelineType type, int frameSize,
+		const _spTimelineVtable* vtable) {
 	struct spBaseTimeline* self = NEW(struct spBaseTimeline);
-	_spCurveTimeline_init(SUPER(self), type, frameCount, _spBaseTimeline_dispose, apply);
+	_spCurveTimeline_initVtable(SUPER(self), type, frameCount, vtable);
 
 	CONST_CAST(int, self->framesLength) = frameCount * frameSize;
 	CONST_CAST(float*, self->frames) = CALLOC(float, self->framesLength);
@@ -289,8 +347,10 @@ void _spRotateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton,
 	bone->rotation += amount * alpha;
 }
 
+static const _spTimelineVtable _spRotateTimeline_vtable = {_spRotateTimeline_apply, _spBaseTimeline_dispose, 0};
+
 spRotateTimeline* spRotateTimeline_create (int frameCount) {
-	return _spBaseTimeline_create(frameCount, TIMELINE_ROTATE, 2, _spRotateTimeline_apply);
+	return _spBaseTimeline_create(frameCount, TIMELINE_ROTATE, 2, &_spRotateTimeline_vtable);
 }
 
 void spRotateTimeline_setFrame (spRotateTimeline* self, int frameIndex, float time, float angle) {
@@ -337,8 +397,10 @@ void _spTranslateTimeline_apply (const spTimeline* timeline, spSkeleton* skeleto
 			* alpha;
 }
 
+static const _spTimelineVtable _spTranslateTimeline_vtable = {_spTranslateTimeline_apply, _spBaseTimeline_dispose, 0};
+
 spTranslateTimeline* spTranslateTimeline_create (int frameCount) {
-	return _spBaseTimeline_create(frameCount, TIMELINE_TRANLATE, 3, _spTranslateTimeline_apply);
+	return _spBaseTimeline_create(frameCount, TIMELINE_TRANLATE, 3, &_spTranslateTimeline_vtable);
 }
 
 void spTranslateTimeline_setFrame (spTranslateTimeline* self, int frameIndex, float time, float x, float y) {
@@ -381,8 +443,10 @@ void _spScaleTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, f
 			- bone->scaleY) * alpha;
 }
 
+static const _spTimelineVtable _spScaleTimeline_vtable = {_spScaleTimeline_apply, _spBaseTimeline_dispose, 0};
+
 spScaleTimeline* spScaleTimeline_create (int frameCount) {
-	return _spBaseTimeline_create(frameCount, TIMELINE_SCALE, 3, _spScaleTimeline_apply);
+	return _spBaseTimeline_create(frameCount, TIMELINE_SCALE, 3, &_spScaleTimeline_vtable);
 }
 
 void spScaleTimeline_setFrame (spScaleTimeline* self, int frameIndex, float time, float x, float y) {
@@ -445,8 +509,10 @@ void _spColorTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, f
 	}
 }
 
+static const _spTimelineVtable _spColorTimeline_vtable = {_spColorTimeline_apply, _spBaseTimeline_dispose, 0};
+
 spColorTimeline* spColorTimeline_create (int frameCount) {
-	return (spColorTimeline*)_spBaseTimeline_create(frameCount, TIMELINE_COLOR, 5, _spColorTimeline_apply);
+	return (spColorTimeline*)_spBaseTimeline_create(frameCount, TIMELINE_COLOR, 5, &_spColorTimeline_vtable);
 }
 
 void spColorTimeline_setFrame (spColorTimeline* self, int frameIndex, float time, float r, float g, float b, float a) {
@@ -491,9 +557,11 @@ void _spAttachmentTimeline_dispose (spTimeline* timeline) {
 	FREE(self);
 }
 
+static const _spTimelineVtable _spAttachmentTimeline_vtable = {_spAttachmentTimeline_apply, _spAttachmentTimeline_dispose, 0};
+
 spAttachmentTimeline* spAttachmentTimeline_create (int frameCount) {
 	spAttachmentTimeline* self = NEW(spAttachmentTimeline);
-	_spTimeline_init(SUPER(self), TIMELINE_ATTACHMENT, _spAttachmentTimeline_dispose, _spAttachmentTimeline_apply);
+	_spTimeline_initVtable(SUPER(self), TIMELINE_ATTACHMENT, &_spAttachmentTimeline_vtable);
 
 	CONST_CAST(int, self->framesLength) = frameCount;
 	CONST_CAST(float*, self->frames) = CALLOC(float, frameCount);
@@ -558,9 +626,11 @@ void _spEventTimeline_dispose (spTimeline* timeline) {
 	FREE(self);
 }
 
+static const _spTimelineVtable _spEventTimeline_vtable = {_spEventTimeline_apply, _spEventTimeline_dispose, 0};
+
 spEventTimeline* spEventTimeline_create (int frameCount) {
 	spEventTimeline* self = NEW(spEventTimeline);
-	_spTimeline_init(SUPER(self), TIMELINE_EVENT, _spEventTimeline_dispose, _spEventTimeline_apply);
+	_spTimeline_initVtable(SUPER(self), TIMELINE_EVENT, &_spEventTimeline_vtable);
 
 	CONST_CAST(int, self->framesLength) = frameCount;
 	CONST_CAST(float*, self->frames) = CALLOC(float, frameCount);
@@ -594,7 +664,7 @@ void _spDrawOrderTimeline_apply (const spTimeline* timeline, spSkeleton* skeleto
 
 	drawOrderToSetupIndex = self->drawOrders[frameIndex];
 	if (!drawOrderToSetupIndex)
-		memcpy(skeleton->drawOrder, skeleton->slots, self->slotCount * sizeof(int));
+		memcpy(skeleton->drawOrder, skeleton->slots, self->slotCount * sizeof(spSlot*));
 	else {
 		for (i = 0; i < self->slotCount; i++)
 			skeleton->drawOrder[i] = skeleton->slots[drawOrderToSetupIndex[i]];
@@ -614,9 +684,11 @@ void _spDrawOrderTimeline_dispose (spTimeline* timeline) {
 	FREE(self);
 }
 
+static const _spTimelineVtable _spDrawOrderTimeline_vtable = {_spDrawOrderTimeline_apply, _spDrawOrderTimeline_dispose, 0};
+
 spDrawOrderTimeline* spDrawOrderTimeline_create (int frameCount, int slotCount) {
 	spDrawOrderTimeline* self = NEW(spDrawOrderTimeline);
-	_spTimeline_init(SUPER(self), TIMELINE_DRAWORDER, _spDrawOrderTimeline_dispose, _spDrawOrderTimeline_apply);
+	_spTimeline_initVtable(SUPER(self), TIMELINE_DRAWORDER, &_spDrawOrderTimeline_vtable);
 
 	CONST_CAST(int, self->framesLength) = frameCount;
 	CONST_CAST(float*, self->frames) = CALLOC(float, frameCount);
@@ -637,3 +709,247 @@ void spDrawOrderTimeline_setFrame (spDrawOrderTimeline* self, int frameIndex, fl
 		memcpy(CONST_CAST(int*, self->drawOrders[frameIndex]), drawOrder, self->slotCount * sizeof(int));
 	}
 }
+
+/**/
+
+static const int QUANTIZED_CURVE_LINEAR = 0;
+static const int QUANTIZED_CURVE_STEPPED = 1;
+static const int QUANTIZED_CURVE_BEZIER = 2;
+static const float QUANTIZED_RANGE = 65535;
+static const float QUANTIZED_FINE_TOLERANCE = 0.01f; /* Scale and color tolerance relative to rotate and translate. */
+
+static float _spQuantizedTimeline_wrapAngle (float angle) {
+	while (angle > 180)
+		angle -= 360;
+	while (angle < -180)
+		angle += 360;
+	return angle;
+}
+
+void _spQuantizedTimeline_apply (const spTimeline* timeline, spSkeleton* skeleton, float lastTime, float time,
+		spEvent** firedEvents, int* eventCount, float alpha) {
+	int i, frameIndex, curveIndex;
+	float last[4], next[4], percent;
+	const unsigned short* values;
+	spQuantizedTimeline* self = SUB_CAST(spQuantizedTimeline, timeline);
+	int n = self->channelCount;
+
+	if (time < self->times[0]) return; /* Time is before first frame. */
+
+	if (time >= self->times[self->frameCount - 1]) { /* Time is after last frame. */
+		values = self->values + (self->frameCount - 1) * n;
+		for (i = 0; i < n; ++i)
+			next[i] = last[i] = self->offsets[i] + values[i] * self->scales[i];
+		percent = 0;
+	} else {
+		/* Decode the last frame and the current frame. */
+		frameIndex = binarySearch(self->times, self->frameCount, time, 1) - 1;
+		values = self->values + frameIndex * n;
+		for (i = 0; i < n; ++i) {
+			last[i] = self->offsets[i] + values[i] * self->scales[i];
+			next[i] = self->offsets[i] + values[i + n] * self->scales[i];
+		}
+		percent = (time - self->times[frameIndex]) / (self->times[frameIndex + 1] - self->times[frameIndex]);
+		percent = percent < 0 ? 0 : (percent > 1 ? 1 : percent);
+
+		curveIndex = self->curveIndices[frameIndex];
+		if (curveIndex == QUANTIZED_CURVE_STEPPED)
+			percent = 0;
+		else if (curveIndex >= QUANTIZED_CURVE_BEZIER)
+			percent = _spCurveTimeline_getCurvePercent(self->curves + (curveIndex - QUANTIZED_CURVE_BEZIER) * 6, percent);
+	}
+
+	switch (self->sourceType) {
+	case TIMELINE_ROTATE: {
+		spBone* bone = skeleton->bones[self->index];
+		float amount = _spQuantizedTimeline_wrapAngle(next[0] - last[0]);
+		amount = _spQuantizedTimeline_wrapAngle(bone->data->rotation + (last[0] + amount * percent) - bone->rotation);
+		bone->rotation += amount * alpha;
+		break;
+	}
+	case TIMELINE_TRANLATE: {
+		spBone* bone = skeleton->bones[self->index];
+		bone->x += (bone->data->x + last[0] + (next[0] - last[0]) * percent - bone->x) * alpha;
+		bone->y += (bone->data->y + last[1] + (next[1] - last[1]) * percent - bone->y) * alpha;
+		break;
+	}
+	case TIMELINE_SCALE: {
+		spBone* bone = skeleton->bones[self->index];
+		bone->scaleX += (bone->data->scaleX - 1 + last[0] + (next[0] - last[0]) * percent - bone->scaleX) * alpha;
+		bone->scaleY += (bone->data->scaleY - 1 + last[1] + (next[1] - last[1]) * percent - bone->scaleY) * alpha;
+		break;
+	}
+	case TIMELINE_COLOR: {
+		spSlot* slot = skeleton->slots[self->index];
+		float r = last[0] + (next[0] - last[0]) * percent;
+		float g = last[1] + (next[1] - last[1]) * percent;
+		float b = last[2] + (next[2] - last[2]) * percent;
+		float a = last[3] + (next[3] - last[3]) * percent;
+		if (alpha < 1 && time < self->times[self->frameCount - 1]) {
+			slot->r += (r - slot->r) * alpha;
+			slot->g += (g - slot->g) * alpha;
+			slot->b += (b - slot->b) * alpha;
+			slot->a += (a - slot->a) * alpha;
+		} else {
+			slot->r = r;
+			slot->g = g;
+			slot->b = b;
+			slot->a = a;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void _spQuantizedTimeline_dispose (spTimeline* timeline) {
+	spQuantizedTimeline* self = SUB_CAST(spQuantizedTimeline, timeline);
+	_spTimeline_deinit(timeline);
+	FREE(self->times); /* All arrays share one block. */
+	FREE(self);
+}
+
+static const _spTimelineVtable _spQuantizedTimeline_vtable = {_spQuantizedTimeline_apply, _spQuantizedTimeline_dispose, 0};
+
+/* Returns how far the value of key "middle" is from the line between keys "first" and "last". */
+static float _spQuantizedTimeline_getError (const float* frames, int frameSize, int/*bool*/angle, int first, int middle,
+		int last, int channel) {
+	const float* a = frames + first * frameSize;
+	const float* m = frames + middle * frameSize;
+	const float* b = frames + last * frameSize;
+	float percent = (m[0] - a[0]) / (b[0] - a[0]);
+	float error;
+	if (angle)
+		error = _spQuantizedTimeline_wrapAngle(a[channel] + _spQuantizedTimeline_wrapAngle(b[channel] - a[channel]) * percent
+				- m[channel]);
+	else
+		error = a[channel] + (b[channel] - a[channel]) * percent - m[channel];
+	return error < 0 ? -error : error;
+}
+
+spQuantizedTimeline* spQuantizedTimeline_create (const spTimeline* source, float tolerance) {
+	int i, ii, c, frameCount, frameSize, channelCount, last, curveCount;
+	int *keys, *curveKeys;
+	unsigned short* curveIndices;
+	float* data;
+	const float* frames;
+	const float* curves;
+	float *min, *max;
+	int/*bool*/angle = 0, constant = 1;
+	spQuantizedTimeline* self;
+	const struct spBaseTimeline* base = (const struct spBaseTimeline*)source;
+
+	switch (source->type) {
+	case TIMELINE_ROTATE:
+		frameSize = 2;
+		angle = 1;
+		break;
+	case TIMELINE_TRANLATE:
+		frameSize = 3;
+		break;
+	case TIMELINE_SCALE:
+		frameSize = 3;
+		tolerance *= QUANTIZED_FINE_TOLERANCE;
+		break;
+	case TIMELINE_COLOR:
+		frameSize = 5;
+		tolerance *= QUANTIZED_FINE_TOLERANCE;
+		break;
+	default:
+		return 0;
+	}
+	frames = base->frames;
+	curves = base->super.curves;
+	frameCount = base->framesLength / frameSize;
+	if (frameCount > QUANTIZED_RANGE - QUANTIZED_CURVE_BEZIER) return 0;
+
+	/* Find the value range of each channel. */
+	min = MALLOC(float, frameSize);
+	max = MALLOC(float, frameSize);
+	for (c = 1; c < frameSize; ++c) {
+		min[c] = max[c] = frames[c];
+		for (i = 1; i < frameCount; ++i) {
+			float value = frames[i * frameSize + c];
+			if (value < min[c]) min[c] = value;
+			if (value > max[c]) max[c] = value;
+		}
+		if (max[c] - min[c] > tolerance) constant = 0;
+	}
+
+	/* Choose the keys to keep. A constant timeline keeps only its first and last keys. Otherwise a key is dropped when it
+	 * lies between two linear segments and the line from the previous kept key stays within tolerance of it. */
+	keys = MALLOC(int, frameCount);
+	keys[0] = 0;
+	for (i = 1, last = 0, ii = 1; i < frameCount - 1; ++i) {
+		int/*bool*/drop = curves[(i - 1) * 6] == CURVE_LINEAR && curves[i * 6] == CURVE_LINEAR;
+		int m;
+		if (constant) continue;
+		for (m = last + 1; drop && m <= i; ++m)
+			for (c = 1; c < frameSize; ++c)
+				if (_spQuantizedTimeline_getError(frames, frameSize, angle, last, m, i + 1, c) > tolerance) drop = 0;
+		if (!drop) keys[ii++] = last = i;
+	}
+	if (frameCount > 1) keys[ii++] = frameCount - 1;
+
+	/* Only bezier segments between two kept keys need curve data, and identical curves are stored once. */
+	curveIndices = MALLOC(unsigned short, ii - 1);
+	curveKeys = MALLOC(int, ii - 1);
+	curveCount = 0;
+	for (i = 0; i < ii - 1; ++i) {
+		const float* curve = curves + keys[i] * 6;
+		if (keys[i + 1] != keys[i] + 1 || curve[0] == CURVE_LINEAR)
+			curveIndices[i] = QUANTIZED_CURVE_LINEAR;
+		else if (curve[0] == CURVE_STEPPED)
+			curveIndices[i] = QUANTIZED_CURVE_STEPPED;
+		else {
+			for (c = 0; c < curveCount; ++c)
+				if (memcmp(curves + curveKeys[c] * 6, curve, 6 * sizeof(float)) == 0) break;
+			if (c == curveCount) curveKeys[curveCount++] = keys[i];
+			curveIndices[i] = (unsigned short)(QUANTIZED_CURVE_BEZIER + c);
+		}
+	}
+
+	/* Lay out the arrays in one block, floats first so the shorts stay aligned. */
+	channelCount = frameSize - 1;
+	data = (float*)_malloc(sizeof(float) * (ii + channelCount * 2 + curveCount * 6)
+			+ sizeof(unsigned short) * (ii * channelCount + ii - 1));
+
+	self = NEW(spQuantizedTimeline);
+	_spTimeline_initVtable(SUPER(self), TIMELINE_QUANTIZED, &_spQuantizedTimeline_vtable);
+	CONST_CAST(spTimelineType, self->sourceType) = source->type;
+	CONST_CAST(int, self->frameCount) = ii;
+	CONST_CAST(int, self->channelCount) = channelCount;
+	CONST_CAST(int, self->curveCount) = curveCount;
+	CONST_CAST(float*, self->times) = data;
+	CONST_CAST(float*, self->offsets) = self->times + ii;
+	CONST_CAST(float*, self->scales) = self->offsets + channelCount;
+	CONST_CAST(float*, self->curves) = self->scales + channelCount;
+	CONST_CAST(unsigned short*, self->values) = (unsigned short*)(self->curves + curveCount * 6);
+	CONST_CAST(unsigned short*, self->curveIndices) = self->values + ii * channelCount;
+	self->index = base->boneIndex;
+
+	for (c = 0; c < channelCount; ++c) {
+		self->offsets[c] = min[c + 1];
+		self->scales[c] = (max[c + 1] - min[c + 1]) / QUANTIZED_RANGE;
+	}
+
+	for (i = 0; i < ii; ++i) {
+		const float* frame = frames + keys[i] * frameSize;
+		self->times[i] = frame[0];
+		for (c = 0; c < channelCount; ++c)
+			self->values[i * channelCount + c] = (unsigned short)(
+					self->scales[c] ? (frame[c + 1] - self->offsets[c]) / self->scales[c] + 0.5f : 0);
+	}
+
+	for (i = 0; i < curveCount; ++i)
+		memcpy(self->curves + i * 6, curves + curveKeys[i] * 6, 6 * sizeof(float));
+	memcpy(self->curveIndices, curveIndices, (ii - 1) * sizeof(unsigned short));
+
+	FREE(curveIndices);
+	FREE(curveKeys);
+	FREE(keys);
+	FREE(min);
+	FREE(max);
+	return self;
+}
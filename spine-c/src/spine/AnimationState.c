@@ -38,41 +38,83 @@
 #include <spine/extension.h>
 #include <spine/Skeleton.h>
 #include <spine/SkeletonData.h>
+#include <spine/SkeletonPose.h>
 #include <string.h>
 
-spTrackEntry* _spTrackEntry_create () {
-	spTrackEntry* entry = NEW(spTrackEntry);
+typedef struct {
+	spAnimationState super;
+	spEvent** events;
+	int eventsCapacity;
+
+	spSkeleton* scratch; /* Poses are sampled here so the skeleton being animated is written once. */
+	spSkeletonPose* base;
+	spSkeletonPose* blended;
+	spSkeletonPose* sample;
+
+	int tracksCapacity;
+	spTrackEntry* freeEntries; /* Disposed entries, linked through next, reused so switching animations doesn't allocate. */
+} _spAnimationState;
+
+spTrackEntry* _spTrackEntry_create (spAnimationState* state) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, state);
+	spTrackEntry* entry = internal->freeEntries;
+	if (entry) {
+		internal->freeEntries = entry->next;
+		memset(entry, 0, sizeof(spTrackEntry));
+	} else
+		entry = NEW(spTrackEntry);
 	entry->timeScale = 1;
 	entry->lastTime = -1;
 	return entry;
 }
 
-void _spTrackEntry_dispose (spTrackEntry* entry) {
-	FREE(entry);
+void _spTrackEntry_dispose (spAnimationState* state, spTrackEntry* entry) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, state);
+	entry->next = internal->freeEntries;
+	internal->freeEntries = entry;
 }
 
-void _spTrackEntry_disposeAll (spTrackEntry* entry) {
+void _spTrackEntry_disposeAll (spAnimationState* state, spTrackEntry* entry) {
 	while (entry) {
 		spTrackEntry* next = entry->next;
-		_spTrackEntry_dispose(entry);
+		_spTrackEntry_dispose(state, entry);
 		entry = next;
 	}
 }
 
-/**/
+/* Disposes the entries being mixed out, which chain through previous when pose blending. */
+void _spTrackEntry_disposePrevious (spAnimationState* state, spTrackEntry* entry) {
+	spTrackEntry* previous = entry->previous;
+	while (previous) {
+		spTrackEntry* next = previous->previous;
+		_spTrackEntry_dispose(state, previous);
+		previous = next;
+	}
+	entry->previous = 0;
+}
 
-typedef struct {
-	spAnimationState super;
-	spEvent** events;
-} _spAnimationState;
+static float _spTrackEntry_getTime (const spTrackEntry* entry) {
+	if (!entry->loop && entry->time > entry->endTime) return entry->endTime;
+	return entry->time;
+}
+
+/**/
 
 void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEntry* entry);
 
+static void _spAnimationState_mix (spAnimationState* self, spAnimation* animation, spSkeleton* skeleton, float lastTime,
+		float time, int loop, spEvent** events, int* eventCount, float alpha) {
+	if (self->mixer)
+		self->mixer(self, animation, skeleton, lastTime, time, loop, events, eventCount, alpha);
+	else
+		spAnimation_mixTimelines(animation, skeleton, lastTime, time, loop, events, eventCount, alpha, self->timelineMask);
+}
+
 spAnimationState* spAnimationState_create (spAnimationStateData* data) {
 	_spAnimationState* internal = NEW(_spAnimationState);
 	spAnimationState* self = SUPER(internal);
-	internal->events = MALLOC(spEvent*, 64);
 	self->timeScale = 1;
+	self->timelineMask = TIMELINE_MASK_ALL;
 	CONST_CAST(spAnimationStateData*, self->data) = data;
 	return self;
 }
@@ -81,8 +123,22 @@ void spAnimationState_dispose (spAnimationState* self) {
 	int i;
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	FREE(internal->events);
-	for (i = 0; i < self->trackCount; i++)
-		_spTrackEntry_disposeAll(self->tracks[i]);
+	if (internal->scratch) {
+		spSkeleton_dispose(internal->scratch);
+		spSkeletonPose_dispose(internal->base);
+		spSkeletonPose_dispose(internal->blended);
+		spSkeletonPose_dispose(internal->sample);
+	}
+	for (i = 0; i < self->trackCount; i++) {
+		if (!self->tracks[i]) continue;
+		_spTrackEntry_disposePrevious(self, self->tracks[i]);
+		_spTrackEntry_disposeAll(self, self->tracks[i]);
+	}
+	while (internal->freeEntries) {
+		spTrackEntry* next = internal->freeEntries->next;
+		FREE(internal->freeEntries);
+		internal->freeEntries = next;
+	}
 	FREE(self->tracks);
 	FREE(self);
 }
@@ -90,6 +146,7 @@ void spAnimationState_dispose (spAnimationState* self) {
 void spAnimationState_update (spAnimationState* self, float delta) {
 	int i;
 	float trackDelta;
+	spTrackEntry* entry;
 	delta *= self->timeScale;
 	for (i = 0; i < self->trackCount; i++) {
 		spTrackEntry* current = self->tracks[i];
@@ -97,9 +154,9 @@ void spAnimationState_update (spAnimationState* self, float delta) {
 
 		trackDelta = delta * current->timeScale;
 		current->time += trackDelta;
-		if (current->previous) {
-			current->previous->time += trackDelta;
-			current->mixTime += trackDelta;
+		for (entry = current; entry->previous; entry = entry->previous) {
+			entry->previous->time += trackDelta;
+			entry->mixTime += trackDelta;
 		}
 
 		if (current->next) {
@@ -111,7 +168,78 @@ void spAnimationState_update (spAnimationState* self, float delta) {
 	}
 }
 
-void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
+/* Grows the events array, which is kept across applies, to hold the events the animation can fire. Called as each entry
+ * becomes current, so applying never counts them. */
+static void _spAnimationState_affirmEvents (_spAnimationState* internal, const spAnimation* animation) {
+	int count = spAnimation_getMaxEventCount(animation);
+	if (count <= internal->eventsCapacity) return;
+	if (count < internal->eventsCapacity * 2) count = internal->eventsCapacity * 2;
+	FREE(internal->events);
+	internal->events = MALLOC(spEvent*, count);
+	internal->eventsCapacity = count;
+}
+
+static void _spAnimationState_affirmPoses (_spAnimationState* internal, spSkeleton* skeleton) {
+	if (internal->scratch) {
+		if (internal->scratch->data == skeleton->data) return;
+		spSkeleton_dispose(internal->scratch);
+		spSkeletonPose_dispose(internal->base);
+		spSkeletonPose_dispose(internal->blended);
+		spSkeletonPose_dispose(internal->sample);
+	}
+	internal->scratch = spSkeleton_create(skeleton->data);
+	internal->base = spSkeletonPose_create(skeleton->boneCount, skeleton->slotCount);
+	internal->blended = spSkeletonPose_create(skeleton->boneCount, skeleton->slotCount);
+	internal->sample = spSkeletonPose_create(skeleton->boneCount, skeleton->slotCount);
+}
+
+/* Leaves the pose of the entry, blended over the entries it is mixing from, in internal->blended. Each entry is sampled from
+ * the base pose, the pose the skeleton had before this track. */
+static void _spAnimationState_blendEntry (spAnimationState* self, spTrackEntry* entry, float time) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	spSkeletonPose* target = internal->blended;
+
+	if (entry->previous) {
+		_spAnimationState_blendEntry(self, entry->previous, _spTrackEntry_getTime(entry->previous));
+		target = internal->sample;
+	}
+
+	spSkeletonPose_restore(internal->base, internal->scratch);
+	if (self->mixer)
+		self->mixer(self, entry->animation, internal->scratch, time, time, entry->loop, 0, 0, 1);
+	else
+		spAnimation_mixTimelines(entry->animation, internal->scratch, time, time, entry->loop, 0, 0, 1,
+				TIMELINE_MASK_POSE & self->timelineMask);
+	spSkeletonPose_capture(target, internal->scratch);
+
+	if (entry->previous) {
+		float alpha = entry->mixTime / entry->mixDuration;
+		spSkeletonPose_blend(internal->blended, internal->sample, alpha > 1 ? 1 : alpha);
+	}
+}
+
+/* Applies attachment, draw order and event timelines to the skeleton, oldest entry first so the newest wins. */
+static void _spAnimationState_applyChanges (spAnimationState* self, spSkeleton* skeleton, spTrackEntry* entry, float lastTime,
+		float time, spEvent** events, int* eventCount) {
+	if (entry->previous) {
+		float previousTime = _spTrackEntry_getTime(entry->previous);
+		_spAnimationState_applyChanges(self, skeleton, entry->previous, previousTime, previousTime, 0, 0);
+	}
+	spAnimation_mixTimelines(entry->animation, skeleton, lastTime, time, entry->loop, events, eventCount, 1,
+			TIMELINE_MASK_CHANGES & self->timelineMask);
+}
+
+/* Disposes the entries older than the newest finished mix, which no longer contribute. */
+static void _spAnimationState_disposeMixedOut (spAnimationState* self, spTrackEntry* current) {
+	spTrackEntry* entry;
+	for (entry = current; entry->previous; entry = entry->previous) {
+		if (entry->mixTime < entry->mixDuration) continue;
+		_spTrackEntry_disposePrevious(self, entry);
+		break;
+	}
+}
+
+static void _spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton, int/*bool*/pose) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 
 	int i, ii;
@@ -128,22 +256,35 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 		if (!current->loop && time > current->endTime) time = current->endTime;
 
 		previous = current->previous;
-		if (!previous) {
-			spAnimation_apply(current->animation, skeleton, current->lastTime, time, current->loop, internal->events, &eventCount);
+		if (!pose) {
+			spAnimation_mixTimelines(current->animation, skeleton, current->lastTime, time, current->loop, internal->events,
+					&eventCount, 1, 1 << TIMELINE_EVENT);
+			_spAnimationState_disposeMixedOut(self, current);
+		} else if (!previous) {
+			_spAnimationState_mix(self, current->animation, skeleton, current->lastTime, time, current->loop, internal->events,
+					&eventCount, 1);
+		} else if (previous->previous) {
+			/* Only reached with poseBlending: a chain of mixes is blended through pose buffers. A mix from a single entry is
+			 * cheaper applied in place below, with the same result. */
+			_spAnimationState_affirmPoses(internal, skeleton);
+			spSkeletonPose_capture(internal->base, skeleton);
+			_spAnimationState_blendEntry(self, current, time);
+			spSkeletonPose_restore(internal->blended, skeleton);
+			_spAnimationState_applyChanges(self, skeleton, current, current->lastTime, time, internal->events, &eventCount);
+			_spAnimationState_disposeMixedOut(self, current);
 		} else {
 			float alpha = current->mixTime / current->mixDuration;
 
 			float previousTime = previous->time;
 			if (!previous->loop && previousTime > previous->endTime) previousTime = previous->endTime;
-			spAnimation_apply(previous->animation, skeleton, previousTime, previousTime, previous->loop, 0, 0);
+			_spAnimationState_mix(self, previous->animation, skeleton, previousTime, previousTime, previous->loop, 0, 0, 1);
 
 			if (alpha >= 1) {
 				alpha = 1;
-				_spTrackEntry_dispose(current->previous);
-				current->previous = 0;
+				_spTrackEntry_disposePrevious(self, current);
 			}
-			spAnimation_mix(current->animation, skeleton, current->lastTime, time, current->loop, internal->events, &eventCount,
-					alpha);
+			_spAnimationState_mix(self, current->animation, skeleton, current->lastTime, time, current->loop, internal->events,
+					&eventCount, alpha);
 		}
 
 		for (ii = 0; ii < eventCount; ii++) {
@@ -166,6 +307,14 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 	}
 }
 
+void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
+	_spAnimationState_apply(self, skeleton, 1);
+}
+
+void spAnimationState_applyEvents (spAnimationState* self, spSkeleton* skeleton) {
+	_spAnimationState_apply(self, skeleton, 0);
+}
+
 void spAnimationState_clearTracks (spAnimationState* self) {
 	int i;
 	for (i = 0; i < self->trackCount; i++)
@@ -183,28 +332,33 @@ void spAnimationState_clearTrack (spAnimationState* self, int trackIndex) {
 	if (self->listener) self->listener(self, trackIndex, ANIMATION_END, 0, 0);
 
 	self->tracks[trackIndex] = 0;
-	if (current->previous) _spTrackEntry_dispose(current->previous);
-	_spTrackEntry_disposeAll(current);
+	_spTrackEntry_disposePrevious(self, current);
+	_spTrackEntry_disposeAll(self, current);
 }
 
 spTrackEntry* _spAnimationState_expandToIndex (spAnimationState* self, int index) {
-	spTrackEntry** newTracks;
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	if (index < self->trackCount) return self->tracks[index];
-	newTracks = CALLOC(spTrackEntry*, index + 1);
-	memcpy(newTracks, self->tracks, self->trackCount * sizeof(spTrackEntry*));
-	FREE(self->tracks);
-	self->tracks = newTracks;
+	if (index >= internal->tracksCapacity) {
+		int capacity = internal->tracksCapacity * 2;
+		spTrackEntry** newTracks;
+		if (capacity <= index) capacity = index + 1;
+		newTracks = MALLOC(spTrackEntry*, capacity);
+		memcpy(newTracks, self->tracks, self->trackCount * sizeof(spTrackEntry*));
+		FREE(self->tracks);
+		self->tracks = newTracks;
+		internal->tracksCapacity = capacity;
+	}
+	memset(self->tracks + self->trackCount, 0, (index + 1 - self->trackCount) * sizeof(spTrackEntry*));
 	self->trackCount = index + 1;
 	return 0;
 }
 
 void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEntry* entry) {
 	spTrackEntry* current = _spAnimationState_expandToIndex(self, index);
+	_spAnimationState_affirmEvents(SUB_CAST(_spAnimationState, self), entry->animation);
 	if (current) {
-		if (current->previous) {
-			_spTrackEntry_dispose(current->previous);
-			current->previous = 0;
-		}
+		if (!self->poseBlending) _spTrackEntry_disposePrevious(self, current);
 
 		if (current->listener) current->listener(self, index, ANIMATION_END, 0, 0);
 		if (self->listener) self->listener(self, index, ANIMATION_END, 0, 0);
@@ -213,8 +367,10 @@ void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEnt
 		if (entry->mixDuration > 0) {
 			entry->mixTime = 0;
 			entry->previous = current;
-		} else
-			_spTrackEntry_dispose(current);
+		} else {
+			_spTrackEntry_disposePrevious(self, current);
+			_spTrackEntry_dispose(self, current);
+		}
 	}
 
 	self->tracks[index] = entry;
@@ -232,9 +388,9 @@ spTrackEntry* spAnimationState_setAnimationByName (spAnimationState* self, int t
 spTrackEntry* spAnimationState_setAnimation (spAnimationState* self, int trackIndex, spAnimation* animation, int/*bool*/loop) {
 	spTrackEntry* entry;
 	spTrackEntry* current = _spAnimationState_expandToIndex(self, trackIndex);
-	if (current) _spTrackEntry_disposeAll(current->next);
+	if (current) _spTrackEntry_disposeAll(self, current->next);
 
-	entry = _spTrackEntry_create();
+	entry = _spTrackEntry_create(self);
 	entry->animation = animation;
 	entry->loop = loop;
 	entry->endTime = animation->duration;
@@ -252,7 +408,7 @@ spTrackEntry* spAnimationState_addAnimation (spAnimationState* self, int trackIn
 		float delay) {
 	spTrackEntry* last;
 
-	spTrackEntry* entry = _spTrackEntry_create();
+	spTrackEntry* entry = _spTrackEntry_create(self);
 	entry->animation = animation;
 	entry->loop = loop;
 	entry->endTime = animation->duration;
@@ -262,8 +418,10 @@ spTrackEntry* spAnimationState_addAnimation (spAnimationState* self, int trackIn
 		while (last->next)
 			last = last->next;
 		last->next = entry;
-	} else
+	} else {
 		self->tracks[trackIndex] = entry;
+		_spAnimationState_affirmEvents(SUB_CAST(_spAnimationState, self), animation);
+	}
 
 	if (delay <= 0) {
 		if (last)
@@ -280,3 +438,35 @@ spTrackEntry* spAnimationState_getCurrent (spAnimationState* self, int trackInde
 	if (trackIndex >= self->trackCount) return 0;
 	return self->tracks[trackIndex];
 }
+
+static spTrackEntry* _spTrackEntry_copy (spAnimationState* state, const spTrackEntry* entry) {
+	spTrackEntry* copy = _spTrackEntry_create(state);
+	*copy = *entry;
+	copy->next = 0;
+	copy->previous = 0;
+	return copy;
+}
+
+void spAnimationState_copyTracks (spAnimationState* self, const spAnimationState* other) {
+	int i;
+	for (i = 0; i < self->trackCount; i++) {
+		if (!self->tracks[i]) continue;
+		_spTrackEntry_disposePrevious(self, self->tracks[i]);
+		_spTrackEntry_disposeAll(self, self->tracks[i]);
+	}
+	self->trackCount = 0;
+	if (other->trackCount) _spAnimationState_expandToIndex(self, other->trackCount - 1);
+
+	for (i = 0; i < other->trackCount; i++) {
+		const spTrackEntry* from = other->tracks[i];
+		spTrackEntry* to;
+		if (!from) continue;
+		self->tracks[i] = _spTrackEntry_copy(self, from);
+		_spAnimationState_affirmEvents(SUB_CAST(_spAnimationState, self), from->animation);
+		/* Entries being mixed out chain through previous, queued entries through next. */
+		for (to = self->tracks[i]; from->previous; from = from->previous, to = to->previous)
+			to->previous = _spTrackEntry_copy(self, from->previous);
+		for (from = other->tracks[i], to = self->tracks[i]; from->next; from = from->next, to = to->next)
+			to->next = _spTrackEntry_copy(self, from->next);
+	}
+}
@@ -34,41 +34,51 @@
 #include <spine/AnimationStateData.h>
 #include <spine/extension.h>
 
-typedef struct _ToEntry _ToEntry;
-struct _ToEntry {
-	spAnimation* animation;
+/* Mixes live in an open addressing hash table keyed on the from and to animation pair, so lookups cost the same however many
+ * mixes are defined. Mixes are never removed, so no tombstones are needed. */
+typedef struct {
+	spAnimation* from;
+	spAnimation* to;
 	float duration;
-	_ToEntry* next;
-};
+} _MixEntry;
 
-_ToEntry* _ToEntry_create (spAnimation* to, float duration) {
-	_ToEntry* self = NEW(_ToEntry);
-	self->animation = to;
-	self->duration = duration;
-	return self;
-}
+typedef struct {
+	int capacity; /* Power of two. */
+	int shift; /* 32 - log2(capacity), to index by the top bits of the hash. */
+	int count;
+	_MixEntry* entries;
+} _MixTable;
 
-void _ToEntry_dispose (_ToEntry* self) {
-	FREE(self);
-}
+static const int MIX_TABLE_INITIAL_CAPACITY = 16;
 
-/**/
-
-typedef struct _FromEntry _FromEntry;
-struct _FromEntry {
-	spAnimation* animation;
-	_ToEntry* toEntries;
-	_FromEntry* next;
-};
+/* Fibonacci hashing: the multiply mixes every bit of the key into the high bits, so those are used as the index. */
+static unsigned int _MixTable_hash (const spAnimation* from, const spAnimation* to) {
+	unsigned int hash = (unsigned int)(((size_t)from >> 3) * 31 + ((size_t)to >> 3));
+	return hash * 2654435769u;
+}
 
-_FromEntry* _FromEntry_create (spAnimation* from) {
-	_FromEntry* self = NEW(_FromEntry);
-	self->animation = from;
-	return self;
+static _MixEntry* _MixTable_find (const _MixTable* self, const spAnimation* from, const spAnimation* to) {
+	int mask = self->capacity - 1;
+	int i = (int)(_MixTable_hash(from, to) >> self->shift);
+	while (1) {
+		_MixEntry* entry = self->entries + i;
+		if (!entry->from || (entry->from == from && entry->to == to)) return entry;
+		i = (i + 1) & mask;
+	}
 }
 
-void _FromEntry_dispose (_FromEntry* self) {
-	FREE(self);
+static void _MixTable_grow (_MixTable* self) {
+	int i;
+	_MixEntry* entries = self->entries;
+	int capacity = self->capacity;
+
+	self->capacity = capacity ? capacity * 2 : MIX_TABLE_INITIAL_CAPACITY;
+	for (self->shift = 32, i = self->capacity; i > 1; i >>= 1)
+		self->shift--;
+	self->entries = CALLOC(_MixEntry, self->capacity);
+	for (i = 0; i < capacity; ++i)
+		if (entries[i].from) *_MixTable_find(self, entries[i].from, entries[i].to) = entries[i];
+	FREE(entries);
 }
 
 /**/
@@ -76,79 +86,59 @@ void _FromEntry_dispose (_FromEntry* self) {
 spAnimationStateData* spAnimationStateData_create (spSkeletonData* skeletonData) {
 	spAnimationStateData* self = NEW(spAnimationStateData);
 	CONST_CAST(spSkeletonData*, self->skeletonData) = skeletonData;
+	CONST_CAST(_MixTable*, self->entries) = NEW(_MixTable);
 	return self;
 }
 
-void spAnimationStateData_dispose (spAnimationStateData* self) {
-	_ToEntry* toEntry;
-	_ToEntry* nextToEntry;
-	_FromEntry* nextFromEntry;
-
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		toEntry = fromEntry->toEntries;
-		while (toEntry) {
-			nextToEntry = toEntry->next;
-			_ToEntry_dispose(toEntry);
-			toEntry = nextToEntry;
-		}
-		nextFromEntry = fromEntry->next;
-		_FromEntry_dispose(fromEntry);
-		fromEntry = nextFromEntry;
-	}
+spAnimationStateData* spAnimationStateData_createOverride (spAnimationStateData* parent) {
+	spAnimationStateData* self = spAnimationStateData_create(parent->skeletonData);
+	CONST_CAST(spAnimationStateData*, self->parent) = parent;
+	self->defaultMix = parent->defaultMix;
+	return self;
+}
 
+void spAnimationStateData_dispose (spAnimationStateData* self) {
+	_MixTable* table = (_MixTable*)self->entries;
+	FREE(table->entries);
+	FREE(table);
 	FREE(self);
 }
 
-void spAnimationStateData_setMixByName (spAnimationStateData* self, const char* fromName, const char* toName, float duration) {
+int spAnimationStateData_setMixByName (spAnimationStateData* self, const char* fromName, const char* toName, float duration) {
 	spAnimation* to;
 	spAnimation* from = spSkeletonData_findAnimation(self->skeletonData, fromName);
-	if (!from) return;
+	if (!from) return 0;
 	to = spSkeletonData_findAnimation(self->skeletonData, toName);
-	if (!to) return;
-	spAnimationStateData_setMix(self, from, to, duration);
+	if (!to) return 0;
+	return spAnimationStateData_setMix(self, from, to, duration);
 }
 
-void spAnimationStateData_setMix (spAnimationStateData* self, spAnimation* from, spAnimation* to, float duration) {
-	/* Find existing FromEntry. */
-	_ToEntry* toEntry;
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		if (fromEntry->animation == from) {
-			/* Find existing ToEntry. */
-			toEntry = fromEntry->toEntries;
-			while (toEntry) {
-				if (toEntry->animation == to) {
-					toEntry->duration = duration;
-					return;
-				}
-				toEntry = toEntry->next;
-			}
-			break; /* Add new ToEntry to the existing FromEntry. */
-		}
-		fromEntry = fromEntry->next;
-	}
-	if (!fromEntry) {
-		fromEntry = _FromEntry_create(from);
-		fromEntry->next = (_FromEntry*)self->entries;
-		CONST_CAST(_FromEntry*, self->entries) = fromEntry;
+int spAnimationStateData_setMix (spAnimationStateData* self, spAnimation* from, spAnimation* to, float duration) {
+	_MixEntry* entry;
+	_MixTable* table = (_MixTable*)self->entries;
+	if (!from || !to) return 0;
+
+	/* Keep the load factor at or below one half so probe sequences stay short. */
+	if ((table->count + 1) * 2 > table->capacity) _MixTable_grow(table);
+
+	entry = _MixTable_find(table, from, to);
+	if (!entry->from) {
+		entry->from = from;
+		entry->to = to;
+		table->count++;
 	}
-	toEntry = _ToEntry_create(to, duration);
-	toEntry->next = fromEntry->toEntries;
-	fromEntry->toEntries = toEntry;
+	entry->duration = duration;
+	return 1;
 }
 
 float spAnimationStateData_getMix (spAnimationStateData* self, spAnimation* from, spAnimation* to) {
-	_FromEntry* fromEntry = (_FromEntry*)self->entries;
-	while (fromEntry) {
-		if (fromEntry->animation == from) {
-			_ToEntry* toEntry = fromEntry->toEntries;
-			while (toEntry) {
-				if (toEntry->animation == to) return toEntry->duration;
-				toEntry = toEntry->next;
-			}
+	const spAnimationStateData* data;
+	for (data = self; data; data = data->parent) {
+		const _MixTable* table = (const _MixTable*)data->entries;
+		if (table->count) {
+			const _MixEntry* entry = _MixTable_find(table, from, to);
+			if (entry->from) return entry->duration;
 		}
-		fromEntry = fromEntry->next;
 	}
 	return self->defaultMix;
 }
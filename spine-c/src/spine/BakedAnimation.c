@@ -0,0 +1,324 @@
+/******************************************************************************
+ * Spine Runtime Software License - Version 1.1
+ * 
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms in whole or in part, with
+ * or without modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. A Spine Essential, Professional, Enterprise, or Education License must
+ *    be purchased from Esoteric Software and the license must remain valid:
+ *    http://esotericsoftware.com/
+ * 2. Redistributions of source code must retain this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer.
+ * 3. Redistributions in binary form must reproduce this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer, in the documentation and/or other materials provided with the
+ *    distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/BakedAnimation.h>
+#include <spine/Skeleton.h>
+#include <spine/extension.h>
+
+static const int BONE_FRAME_SIZE = 5;
+static const int SLOT_FRAME_SIZE = 4;
+
+/* Returns the type of a timeline as it was keyed, looking through quantized timelines, and its bone or slot index. */
+static spTimelineType _spBakedAnimation_getType (const spTimeline* timeline, int* index) {
+	if (timeline->type == TIMELINE_QUANTIZED) {
+		const spQuantizedTimeline* quantized = SUB_CAST(spQuantizedTimeline, timeline);
+		*index = quantized->index;
+		return quantized->sourceType;
+	}
+	switch (timeline->type) {
+	case TIMELINE_ROTATE:
+	case TIMELINE_TRANLATE:
+	case TIMELINE_SCALE:
+		*index = SUB_CAST(spRotateTimeline, timeline)->boneIndex;
+		break;
+	case TIMELINE_COLOR:
+		*index = SUB_CAST(spColorTimeline, timeline)->slotIndex;
+		break;
+	default:
+		*index = -1;
+	}
+	return timeline->type;
+}
+
+/* Returns the time of the first key of a sampled timeline. */
+static float _spBakedAnimation_getStart (const spTimeline* timeline) {
+	if (timeline->type == TIMELINE_QUANTIZED) return SUB_CAST(spQuantizedTimeline, timeline)->times[0];
+	if (timeline->type == TIMELINE_COLOR) return SUB_CAST(spColorTimeline, timeline)->frames[0];
+	return SUB_CAST(spRotateTimeline, timeline)->frames[0];
+}
+
+/* Records the first key time of a channel, keeping the earliest when several timelines key it. */
+static void _spBakedAnimation_setStart (float* start, int/*bool*/keyed, const spTimeline* timeline) {
+	float time = _spBakedAnimation_getStart(timeline);
+	if (!keyed || time < *start) *start = time;
+}
+
+static int/*bool*/_spBakedAnimation_isSampled (const spTimeline* timeline) {
+	int index;
+	switch (_spBakedAnimation_getType(timeline, &index)) {
+	case TIMELINE_ROTATE:
+	case TIMELINE_TRANLATE:
+	case TIMELINE_SCALE:
+	case TIMELINE_COLOR:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static float _spBakedAnimation_getFrameTime (const spBakedAnimation* self, int frame) {
+	float time = frame / self->rate;
+	return time > self->animation->duration ? self->animation->duration : time;
+}
+
+spBakedAnimation* spBakedAnimation_create (const spAnimation* animation, spSkeletonData* skeletonData, float rate) {
+	int i, frame;
+	int *boneLookup, *slotLookup, *boneChannels, *slotKeyed;
+	float *boneStarts, *slotStarts, *bones, *slots;
+	spSkeleton* skeleton;
+
+	spBakedAnimation* self = NEW(spBakedAnimation);
+	CONST_CAST(const spAnimation*, self->animation) = animation;
+	CONST_CAST(float, self->rate) = rate;
+	CONST_CAST(int, self->frameCount) = (int)ceil(animation->duration * rate) + 1;
+
+	/* Assign a table column to each keyed bone and slot. */
+	boneLookup = MALLOC(int, skeletonData->boneCount);
+	for (i = 0; i < skeletonData->boneCount; ++i)
+		boneLookup[i] = -1;
+	slotLookup = MALLOC(int, skeletonData->slotCount);
+	for (i = 0; i < skeletonData->slotCount; ++i)
+		slotLookup[i] = -1;
+
+	for (i = 0; i < animation->timelineCount; ++i) {
+		spTimeline* timeline = animation->timelines[i];
+		int index;
+		spTimelineType type = _spBakedAnimation_getType(timeline, &index);
+		if (type == TIMELINE_COLOR) {
+			if (slotLookup[index] == -1) slotLookup[index] = CONST_CAST(int, self->slotCount)++;
+		} else if (_spBakedAnimation_isSampled(timeline)) {
+			if (boneLookup[index] == -1) boneLookup[index] = CONST_CAST(int, self->boneCount)++;
+		} else
+			++CONST_CAST(int, self->changeCount);
+	}
+
+	CONST_CAST(int*, self->boneIndices) = MALLOC(int, self->boneCount);
+	for (i = 0; i < skeletonData->boneCount; ++i)
+		if (boneLookup[i] != -1) CONST_CAST(int*, self->boneIndices)[boneLookup[i]] = i;
+	CONST_CAST(int*, self->slotIndices) = MALLOC(int, self->slotCount);
+	for (i = 0; i < skeletonData->slotCount; ++i)
+		if (slotLookup[i] != -1) CONST_CAST(int*, self->slotIndices)[slotLookup[i]] = i;
+
+	/* Each channel is applied from its first key on, like the timelines it is sampled from. */
+	boneChannels = CALLOC(int, self->boneCount);
+	boneStarts = MALLOC(float, self->boneCount * 3);
+	slotKeyed = CALLOC(int, self->slotCount);
+	slotStarts = MALLOC(float, self->slotCount);
+	CONST_CAST(spTimeline**, self->changes) = MALLOC(spTimeline*, self->changeCount);
+	CONST_CAST(int, self->changeCount) = 0;
+	for (i = 0; i < animation->timelineCount; ++i) {
+		spTimeline* timeline = animation->timelines[i];
+		int index, column;
+		switch (_spBakedAnimation_getType(timeline, &index)) {
+		case TIMELINE_TRANLATE:
+			column = boneLookup[index];
+			_spBakedAnimation_setStart(boneStarts + column * 3, boneChannels[column] & BAKED_TRANSLATE, timeline);
+			boneChannels[column] |= BAKED_TRANSLATE;
+			break;
+		case TIMELINE_ROTATE:
+			column = boneLookup[index];
+			_spBakedAnimation_setStart(boneStarts + column * 3 + 1, boneChannels[column] & BAKED_ROTATE, timeline);
+			boneChannels[column] |= BAKED_ROTATE;
+			break;
+		case TIMELINE_SCALE:
+			column = boneLookup[index];
+			_spBakedAnimation_setStart(boneStarts + column * 3 + 2, boneChannels[column] & BAKED_SCALE, timeline);
+			boneChannels[column] |= BAKED_SCALE;
+			break;
+		case TIMELINE_COLOR:
+			column = slotLookup[index];
+			_spBakedAnimation_setStart(slotStarts + column, slotKeyed[column], timeline);
+			slotKeyed[column] = 1;
+			break;
+		default:
+			self->changes[CONST_CAST(int, self->changeCount)++] = timeline;
+		}
+	}
+	CONST_CAST(int*, self->boneChannels) = boneChannels;
+	CONST_CAST(float*, self->boneStarts) = boneStarts;
+	CONST_CAST(float*, self->slotStarts) = slotStarts;
+
+	FREE(boneLookup);
+	FREE(slotLookup);
+	FREE(slotKeyed);
+
+	/* Sample the bone and color timelines on a scratch skeleton, starting from the setup pose for every frame. */
+	bones = MALLOC(float, self->frameCount * self->boneCount * BONE_FRAME_SIZE);
+	slots = MALLOC(float, self->frameCount * self->slotCount * SLOT_FRAME_SIZE);
+	skeleton = spSkeleton_create(skeletonData);
+
+	for (frame = 0; frame < self->frameCount; ++frame) {
+		float time = _spBakedAnimation_getFrameTime(self, frame);
+		float* boneFrame = bones + frame * self->boneCount * BONE_FRAME_SIZE;
+		float* slotFrame = slots + frame * self->slotCount * SLOT_FRAME_SIZE;
+
+		spSkeleton_setBonesToSetupPose(skeleton);
+		for (i = 0; i < self->slotCount; ++i) {
+			spSlot* slot = skeleton->slots[self->slotIndices[i]];
+			slot->r = slot->data->r;
+			slot->g = slot->data->g;
+			slot->b = slot->data->b;
+			slot->a = slot->data->a;
+		}
+
+		for (i = 0; i < animation->timelineCount; ++i)
+			if (_spBakedAnimation_isSampled(animation->timelines[i]))
+				spTimeline_apply(animation->timelines[i], skeleton, time, time, 0, 0, 1);
+
+		for (i = 0; i < self->boneCount; ++i, boneFrame += BONE_FRAME_SIZE) {
+			spBone* bone = skeleton->bones[self->boneIndices[i]];
+			boneFrame[0] = bone->x;
+			boneFrame[1] = bone->y;
+			boneFrame[2] = bone->rotation;
+			boneFrame[3] = bone->scaleX;
+			boneFrame[4] = bone->scaleY;
+		}
+		for (i = 0; i < self->slotCount; ++i, slotFrame += SLOT_FRAME_SIZE) {
+			spSlot* slot = skeleton->slots[self->slotIndices[i]];
+			slotFrame[0] = slot->r;
+			slotFrame[1] = slot->g;
+			slotFrame[2] = slot->b;
+			slotFrame[3] = slot->a;
+		}
+	}
+
+	spSkeleton_dispose(skeleton);
+	CONST_CAST(float*, self->bones) = bones;
+	CONST_CAST(float*, self->slots) = slots;
+	return self;
+}
+
+void spBakedAnimation_dispose (spBakedAnimation* self) {
+	FREE(self->boneIndices);
+	FREE(self->boneChannels);
+	FREE(self->boneStarts);
+	FREE(self->bones);
+	FREE(self->slotIndices);
+	FREE(self->slotStarts);
+	FREE(self->slots);
+	FREE(self->changes);
+	FREE(self);
+}
+
+void spBakedAnimation_apply (const spBakedAnimation* self, spSkeleton* skeleton, float lastTime, float time, int loop,
+		spEvent** events, int* eventCount, float alpha) {
+	int i, frame, nextFrame;
+	float percent;
+	const float *boneFrame, *nextBoneFrame, *boneStart, *slotFrame, *nextSlotFrame;
+	float duration = self->animation->duration;
+
+	if (loop && duration) {
+		time = FMOD(time, duration);
+		lastTime = FMOD(lastTime, duration);
+	}
+
+	for (i = 0; i < self->changeCount; ++i)
+		spTimeline_apply(self->changes[i], skeleton, lastTime, time, events, eventCount, alpha);
+
+	/* Find the two frames around the time. The last frame may be closer than 1 / rate to the one before it. */
+	if (time <= 0 || self->frameCount == 1) {
+		frame = 0;
+		percent = 0;
+	} else {
+		frame = (int)(time * self->rate);
+		if (frame >= self->frameCount - 1) {
+			frame = self->frameCount - 2;
+			percent = 1;
+		} else {
+			float frameTime = _spBakedAnimation_getFrameTime(self, frame);
+			percent = (time - frameTime) / (_spBakedAnimation_getFrameTime(self, frame + 1) - frameTime);
+			if (percent > 1) percent = 1;
+		}
+	}
+	nextFrame = self->frameCount == 1 ? frame : frame + 1;
+
+	boneFrame = self->bones + frame * self->boneCount * BONE_FRAME_SIZE;
+	nextBoneFrame = self->bones + nextFrame * self->boneCount * BONE_FRAME_SIZE;
+	boneStart = self->boneStarts;
+	for (i = 0; i < self->boneCount; ++i, boneFrame += BONE_FRAME_SIZE, nextBoneFrame += BONE_FRAME_SIZE, boneStart += 3) {
+		spBone* bone = skeleton->bones[self->boneIndices[i]];
+		int channels = self->boneChannels[i];
+		if (channels & BAKED_TRANSLATE && time >= boneStart[0]) {
+			bone->x += (boneFrame[0] + (nextBoneFrame[0] - boneFrame[0]) * percent - bone->x) * alpha;
+			bone->y += (boneFrame[1] + (nextBoneFrame[1] - boneFrame[1]) * percent - bone->y) * alpha;
+		}
+		if (channels & BAKED_ROTATE && time >= boneStart[1]) {
+			float amount = nextBoneFrame[2] - boneFrame[2];
+			while (amount > 180)
+				amount -= 360;
+			while (amount < -180)
+				amount += 360;
+			amount = boneFrame[2] + amount * percent - bone->rotation;
+			while (amount > 180)
+				amount -= 360;
+			while (amount < -180)
+				amount += 360;
+			bone->rotation += amount * alpha;
+		}
+		if (channels & BAKED_SCALE && time >= boneStart[2]) {
+			bone->scaleX += (boneFrame[3] + (nextBoneFrame[3] - boneFrame[3]) * percent - bone->scaleX) * alpha;
+			bone->scaleY += (boneFrame[4] + (nextBoneFrame[4] - boneFrame[4]) * percent - bone->scaleY) * alpha;
+		}
+	}
+
+	slotFrame = self->slots + frame * self->slotCount * SLOT_FRAME_SIZE;
+	nextSlotFrame = self->slots + nextFrame * self->slotCount * SLOT_FRAME_SIZE;
+	for (i = 0; i < self->slotCount; ++i, slotFrame += SLOT_FRAME_SIZE, nextSlotFrame += SLOT_FRAME_SIZE) {
+		spSlot* slot;
+		float r, g, b, a;
+		if (time < self->slotStarts[i]) continue;
+		slot = skeleton->slots[self->slotIndices[i]];
+		r = slotFrame[0] + (nextSlotFrame[0] - slotFrame[0]) * percent;
+		g = slotFrame[1] + (nextSlotFrame[1] - slotFrame[1]) * percent;
+		b = slotFrame[2] + (nextSlotFrame[2] - slotFrame[2]) * percent;
+		a = slotFrame[3] + (nextSlotFrame[3] - slotFrame[3]) * percent;
+		if (alpha < 1) {
+			slot->r += (r - slot->r) * alpha;
+			slot->g += (g - slot->g) * alpha;
+			slot->b += (b - slot->b) * alpha;
+			slot->a += (a - slot->a) * alpha;
+		} else {
+			slot->r = r;
+			slot->g = g;
+			slot->b = b;
+			slot->a = a;
+		}
+	}
+}
+
+int spBakedAnimation_getSize (const spBakedAnimation* self) {
+	return sizeof(spBakedAnimation) //
+			+ self->boneCount * (2 * sizeof(int) + 3 * sizeof(float) + self->frameCount * BONE_FRAME_SIZE * sizeof(float)) //
+			+ self->slotCount * (sizeof(int) + sizeof(float) + self->frameCount * SLOT_FRAME_SIZE * sizeof(float)) //
+			+ self->changeCount * sizeof(spTimeline*);
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Spine Runtime Software License - Version 1.1
+ * 
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms in whole or in part, with
+ * or without modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. A Spine Essential, Professional, Enterprise, or Education License must
+ *    be purchased from Esoteric Software and the license must remain valid:
+ *    http://esotericsoftware.com/
+ * 2. Redistributions of source code must retain this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer.
+ * 3. Redistributions in binary form must reproduce this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer, in the documentation and/or other materials provided with the
+ *    distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+
+#include <spine/FixedStep.h>
+#include <spine/Skeleton.h>
+#include <spine/extension.h>
+
+spFixedStep* spFixedStep_create (float step, int boneCount, int slotCount) {
+	int i;
+	spFixedStep* self = NEW(spFixedStep);
+	CONST_CAST(float, self->step) = step;
+	for (i = 0; i < 3; ++i)
+		CONST_CAST(spSkeletonPose*, self->poses[i]) = spSkeletonPose_create(boneCount, slotCount);
+	return self;
+}
+
+void spFixedStep_dispose (spFixedStep* self) {
+	int i;
+	for (i = 0; i < 3; ++i)
+		spSkeletonPose_dispose(self->poses[i]);
+	FREE(self);
+}
+
+int spFixedStep_advance (spFixedStep* self, spSkeleton* skeleton, float delta) {
+	int steps = 0;
+	/* Accumulated in double so long sessions don't drift. */
+	for (self->time += delta; self->time >= self->step; self->time -= self->step)
+		steps++;
+	if (steps && self->sampled) spSkeletonPose_restore(self->poses[1], skeleton);
+	return steps;
+}
+
+void spFixedStep_step (spFixedStep* self, spSkeleton* skeleton, spAnimationState* state, int/*bool*/pose) {
+	spSkeletonPose* last;
+
+	spSkeleton_update(skeleton, self->step);
+	if (!state) return;
+	spAnimationState_update(state, self->step);
+	if (!pose) {
+		spAnimationState_applyEvents(state, skeleton);
+		return;
+	}
+	spAnimationState_apply(state, skeleton);
+
+	last = self->poses[0];
+	CONST_CAST(spSkeletonPose*, self->poses[0]) = self->poses[1];
+	CONST_CAST(spSkeletonPose*, self->poses[1]) = last;
+	spSkeletonPose_capture(self->poses[1], skeleton);
+	if (!self->sampled) {
+		spSkeletonPose_copy(self->poses[0], self->poses[1]);
+		self->sampled = 1;
+	}
+}
+
+int spFixedStep_interpolate (spFixedStep* self, spSkeleton* skeleton) {
+	if (!self->sampled) return 0;
+	spSkeletonPose_copy(self->poses[2], self->poses[0]);
+	spSkeletonPose_blend(self->poses[2], self->poses[1], (float)(self->time / self->step));
+	spSkeletonPose_restore(self->poses[2], skeleton);
+	return 1;
+}
@@ -34,6 +34,14 @@
 #include <spine/RegionAttachment.h>
 #include <spine/extension.h>
 
+#if !defined(SPINE_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SPINE_SSE
+#include <xmmintrin.h>
+#elif !defined(SPINE_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SPINE_NEON
+#include <arm_neon.h>
+#endif
+
 void _spRegionAttachment_dispose (spAttachment* attachment) {
 	spRegionAttachment* self = SUB_CAST(spRegionAttachment, attachment);
 
@@ -118,3 +126,154 @@ void spRegionAttachment_computeWorldVertices (spRegionAttachment* self, float x,
 	vertices[VERTEX_X4] = offset[VERTEX_X4] * bone->m00 + offset[VERTEX_Y4] * bone->m01 + x;
 	vertices[VERTEX_Y4] = offset[VERTEX_X4] * bone->m10 + offset[VERTEX_Y4] * bone->m11 + y;
 }
+
+#if defined(SPINE_SSE)
+
+/* Vertices are transformed two at a time as x, y, x, y lanes: the lanes times m00, m11 plus the lanes with x and y swapped
+ * times m01, m10. The bounds are kept in the same layout and folded at the end. */
+static void _spRegionAttachment_transformSlot (const spSlot* slot, const spRegionAttachment* attachment, float x, float y,
+		float* vertices, __m128* a, __m128* b) {
+	const spBone* bone = slot->bone;
+	const float* offset = attachment->offset;
+	__m128 diagonal = _mm_setr_ps(bone->m00, bone->m11, bone->m00, bone->m11);
+	__m128 cross = _mm_setr_ps(bone->m01, bone->m10, bone->m01, bone->m10);
+	__m128 translation = _mm_setr_ps(x + bone->worldX, y + bone->worldY, x + bone->worldX, y + bone->worldY);
+	*a = _mm_loadu_ps(offset);
+	*b = _mm_loadu_ps(offset + 4);
+	*a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(*a, diagonal), _mm_mul_ps(_mm_shuffle_ps(*a, *a, _MM_SHUFFLE(2, 3, 0, 1)), cross)),
+			translation);
+	*b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(*b, diagonal), _mm_mul_ps(_mm_shuffle_ps(*b, *b, _MM_SHUFFLE(2, 3, 0, 1)), cross)),
+			translation);
+	_mm_storeu_ps(vertices, *a);
+	_mm_storeu_ps(vertices + 4, *b);
+}
+
+void spRegionAttachment_computeWorldVerticesBatch (spSlot** slots, spRegionAttachment** attachments, int count, float x, float y,
+		float* vertices, float* bounds) {
+	int i;
+	float lo[4], hi[4];
+	__m128 a, b, min, max;
+	if (!bounds) {
+		for (i = 0; i < count; ++i, vertices += 8)
+			_spRegionAttachment_transformSlot(slots[i], attachments[i], x, y, vertices, &a, &b);
+		return;
+	}
+	min = _mm_setr_ps(bounds[0], bounds[1], bounds[0], bounds[1]);
+	max = _mm_setr_ps(bounds[2], bounds[3], bounds[2], bounds[3]);
+	for (i = 0; i < count; ++i, vertices += 8) {
+		_spRegionAttachment_transformSlot(slots[i], attachments[i], x, y, vertices, &a, &b);
+		min = _mm_min_ps(min, _mm_min_ps(a, b));
+		max = _mm_max_ps(max, _mm_max_ps(a, b));
+	}
+	_mm_storeu_ps(lo, min);
+	_mm_storeu_ps(hi, max);
+	bounds[0] = lo[0] < lo[2] ? lo[0] : lo[2];
+	bounds[1] = lo[1] < lo[3] ? lo[1] : lo[3];
+	bounds[2] = hi[0] > hi[2] ? hi[0] : hi[2];
+	bounds[3] = hi[1] > hi[3] ? hi[1] : hi[3];
+}
+
+#elif defined(SPINE_NEON)
+
+/* Same lane layout as the SSE version. */
+static void _spRegionAttachment_transformSlot (const spSlot* slot, const spRegionAttachment* attachment, float x, float y,
+		float* vertices, float32x4_t* a, float32x4_t* b) {
+	const spBone* bone = slot->bone;
+	const float* offset = attachment->offset;
+	float lanes[4];
+	float32x4_t diagonal, cross, translation;
+	lanes[0] = lanes[2] = bone->m00;
+	lanes[1] = lanes[3] = bone->m11;
+	diagonal = vld1q_f32(lanes);
+	lanes[0] = lanes[2] = bone->m01;
+	lanes[1] = lanes[3] = bone->m10;
+	cross = vld1q_f32(lanes);
+	lanes[0] = lanes[2] = x + bone->worldX;
+	lanes[1] = lanes[3] = y + bone->worldY;
+	translation = vld1q_f32(lanes);
+	*a = vld1q_f32(offset);
+	*b = vld1q_f32(offset + 4);
+	*a = vaddq_f32(vaddq_f32(vmulq_f32(*a, diagonal), vmulq_f32(vrev64q_f32(*a), cross)), translation);
+	*b = vaddq_f32(vaddq_f32(vmulq_f32(*b, diagonal), vmulq_f32(vrev64q_f32(*b), cross)), translation);
+	vst1q_f32(vertices, *a);
+	vst1q_f32(vertices + 4, *b);
+}
+
+void spRegionAttachment_computeWorldVerticesBatch (spSlot** slots, spRegionAttachment** attachments, int count, float x, float y,
+		float* vertices, float* bounds) {
+	int i;
+	float lo[4], hi[4];
+	float32x4_t a, b, min, max;
+	if (!bounds) {
+		for (i = 0; i < count; ++i, vertices += 8)
+			_spRegionAttachment_transformSlot(slots[i], attachments[i], x, y, vertices, &a, &b);
+		return;
+	}
+	lo[0] = lo[2] = bounds[0];
+	lo[1] = lo[3] = bounds[1];
+	hi[0] = hi[2] = bounds[2];
+	hi[1] = hi[3] = bounds[3];
+	min = vld1q_f32(lo);
+	max = vld1q_f32(hi);
+	for (i = 0; i < count; ++i, vertices += 8) {
+		_spRegionAttachment_transformSlot(slots[i], attachments[i], x, y, vertices, &a, &b);
+		min = vminq_f32(min, vminq_f32(a, b));
+		max = vmaxq_f32(max, vmaxq_f32(a, b));
+	}
+	vst1q_f32(lo, min);
+	vst1q_f32(hi, max);
+	bounds[0] = lo[0] < lo[2] ? lo[0] : lo[2];
+	bounds[1] = lo[1] < lo[3] ? lo[1] : lo[3];
+	bounds[2] = hi[0] > hi[2] ? hi[0] : hi[2];
+	bounds[3] = hi[1] > hi[3] ? hi[1] : hi[3];
+}
+
+#else
+
+void spRegionAttachment_computeWorldVerticesBatch (spSlot** slots, spRegionAttachment** attachments, int count, float x, float y,
+		float* vertices, float* bounds) {
+	int i, ii;
+	float minX, minY, maxX, maxY;
+	if (!bounds) {
+		for (i = 0; i < count; ++i, vertices += 8)
+			spRegionAttachment_computeWorldVertices(attachments[i], x, y, slots[i]->bone, vertices);
+		return;
+	}
+	minX = bounds[0];
+	minY = bounds[1];
+	maxX = bounds[2];
+	maxY = bounds[3];
+	for (i = 0; i < count; ++i, vertices += 8) {
+		spRegionAttachment_computeWorldVertices(attachments[i], x, y, slots[i]->bone, vertices);
+		for (ii = 0; ii < 8; ii += 2) {
+			if (vertices[ii] < minX) minX = vertices[ii];
+			if (vertices[ii] > maxX) maxX = vertices[ii];
+			if (vertices[ii + 1] < minY) minY = vertices[ii + 1];
+			if (vertices[ii + 1] > maxY) maxY = vertices[ii + 1];
+		}
+	}
+	bounds[0] = minX;
+	bounds[1] = minY;
+	bounds[2] = maxX;
+	bounds[3] = maxY;
+}
+
+#endif
+
+int spRegionAttachment_splitRuns (spSlot** slots, spRegionAttachment** attachments, int count, spRegionRun* runs) {
+	int i, runCount = 0;
+	spRegionRun* run = 0;
+	for (i = 0; i < count; ++i) {
+		spAtlasPage* page = ((spAtlasRegion*)attachments[i]->rendererObject)->page;
+		int additive = slots[i]->data->additiveBlending != 0;
+		if (!run || run->page != page || run->additive != additive) {
+			run = runs + runCount++;
+			run->page = page;
+			run->additive = additive;
+			run->start = i;
+			run->count = 0;
+		}
+		run->count++;
+	}
+	return runCount;
+}
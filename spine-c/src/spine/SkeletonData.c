@@ -33,8 +33,22 @@
 
 #include <spine/SkeletonData.h>
 #include <string.h>
+#include <float.h>
+#include <spine/Skeleton.h>
+#include <spine/RegionAttachment.h>
 #include <spine/extension.h>
 
+static void _spSkeletonData_disposeAnimationBounds (spSkeletonData* self) {
+	int i;
+	if (!self->animationBounds) return;
+	for (i = 0; i < self->animationCount; ++i)
+		FREE(self->animationBounds[i]);
+	FREE(self->animationBounds);
+	FREE(self->animationBoundsCounts);
+	self->animationBounds = 0;
+	self->animationBoundsCounts = 0;
+}
+
 spSkeletonData* spSkeletonData_create () {
 	return NEW(spSkeletonData);
 }
@@ -61,6 +75,8 @@ void spSkeletonData_dispose (spSkeletonData* self) {
 		spEventData_dispose(self->events[i]);
 	FREE(self->events);
 
+	_spSkeletonData_disposeAnimationBounds(self);
+
 	FREE(self);
 }
 
@@ -112,3 +128,122 @@ spAnimation* spSkeletonData_findAnimation (const spSkeletonData* self, const cha
 		if (strcmp(self->animations[i]->name, animationName) == 0) return self->animations[i];
 	return 0;
 }
+
+void spSkeletonData_computeAnimationBounds (spSkeletonData* self, float sampleRate, float segmentDuration) {
+	int i, ii, iii;
+	float* radii = CALLOC(float, self->slotCount);
+	spSkeleton* scratch;
+
+	_spSkeletonData_disposeAnimationBounds(self);
+	self->boundsSegment = segmentDuration;
+
+	/* The furthest region corner any skin can put on each slot, so skins and attachment changes stay inside the boxes. */
+	for (i = -1; i < self->skinCount; ++i) {
+		spSkin* skin = i < 0 ? self->defaultSkin : self->skins[i];
+		int slotIndex;
+		if (!skin) continue;
+		for (slotIndex = 0; slotIndex < self->slotCount; ++slotIndex) {
+			const char* name;
+			for (ii = 0; (name = spSkin_getAttachmentName(skin, slotIndex, ii)) != 0; ++ii) {
+				spAttachment* attachment = spSkin_getAttachment(skin, slotIndex, name);
+				if (!attachment || attachment->type != ATTACHMENT_REGION) continue;
+				for (iii = 0; iii < 8; iii += 2) {
+					const float* offset = SUB_CAST(spRegionAttachment, attachment)->offset + iii;
+					float radius = (float)sqrt(offset[0] * offset[0] + offset[1] * offset[1]);
+					if (radius > radii[slotIndex]) radii[slotIndex] = radius;
+				}
+			}
+		}
+	}
+
+	scratch = spSkeleton_create(self);
+	self->animationBoundsCounts = MALLOC(int, self->animationCount);
+	self->animationBounds = MALLOC(float*, self->animationCount);
+	for (i = 0; i < self->animationCount; ++i) {
+		spAnimation* animation = self->animations[i];
+		int count = segmentDuration > 0 && animation->duration > segmentDuration ?
+				(int)ceil(animation->duration / segmentDuration) : 1;
+		float* bounds = MALLOC(float, count * 4);
+		self->animationBoundsCounts[i] = count;
+		self->animationBounds[i] = bounds;
+
+		for (ii = 0; ii < count; ++ii, bounds += 4) {
+			/* Segments share their end samples, so a time on a boundary is inside the boxes on both sides. */
+			float start = count == 1 ? 0 : ii * segmentDuration;
+			float end = count == 1 || ii == count - 1 ? animation->duration : start + segmentDuration;
+			int samples = (int)ceil((end - start) * sampleRate), sample;
+			float last[4], margin = 0;
+			bounds[0] = bounds[1] = FLT_MAX;
+			bounds[2] = bounds[3] = -FLT_MAX;
+
+			for (sample = 0; sample <= samples; ++sample) {
+				float time = samples ? start + (end - start) * sample / samples : start;
+				float box[4];
+				box[0] = box[1] = FLT_MAX;
+				box[2] = box[3] = -FLT_MAX;
+				spAnimation_sample(animation, scratch, time, 0);
+				spSkeleton_updateWorldTransform(scratch);
+
+				/* A bone's world matrix is a rotation and a scale, so no corner is further from the bone than the slot's
+				 * radius times the larger scale. */
+				for (iii = 0; iii < self->slotCount; ++iii) {
+					spBone* bone = scratch->slots[iii]->bone;
+					float scaleX = bone->worldScaleX < 0 ? -bone->worldScaleX : bone->worldScaleX;
+					float scaleY = bone->worldScaleY < 0 ? -bone->worldScaleY : bone->worldScaleY;
+					float radius = radii[iii] * (scaleX > scaleY ? scaleX : scaleY);
+					if (radii[iii] == 0) continue;
+					if (bone->worldX - radius < box[0]) box[0] = bone->worldX - radius;
+					if (bone->worldY - radius < box[1]) box[1] = bone->worldY - radius;
+					if (bone->worldX + radius > box[2]) box[2] = bone->worldX + radius;
+					if (bone->worldY + radius > box[3]) box[3] = bone->worldY + radius;
+				}
+
+				/* Motion between samples is covered by padding with the most any edge moved from one sample to the next. */
+				for (iii = 0; iii < 4; ++iii) {
+					if (sample > 0 && box[iii] != FLT_MAX && box[iii] != -FLT_MAX) {
+						float delta = box[iii] > last[iii] ? box[iii] - last[iii] : last[iii] - box[iii];
+						if (delta > margin) margin = delta;
+					}
+					last[iii] = box[iii];
+				}
+				if (box[0] < bounds[0]) bounds[0] = box[0];
+				if (box[1] < bounds[1]) bounds[1] = box[1];
+				if (box[2] > bounds[2]) bounds[2] = box[2];
+				if (box[3] > bounds[3]) bounds[3] = box[3];
+			}
+
+			if (bounds[0] <= bounds[2]) {
+				bounds[0] -= margin;
+				bounds[1] -= margin;
+				bounds[2] += margin;
+				bounds[3] += margin;
+			}
+		}
+	}
+
+	spSkeleton_dispose(scratch);
+	FREE(radii);
+}
+
+int/*bool*/spSkeletonData_growAnimationBounds (const spSkeletonData* self, const spAnimation* animation, float time,
+		int/*bool*/loop, float* bounds) {
+	int i, index;
+	const float* box;
+	if (!self->animationBounds) return 0;
+
+	for (i = 0; i < self->animationCount; ++i)
+		if (self->animations[i] == animation) break;
+	if (i == self->animationCount) return 0;
+
+	if (loop && animation->duration) time = FMOD(time, animation->duration);
+	index = self->boundsSegment > 0 ? (int)(time / self->boundsSegment) : 0;
+	if (index >= self->animationBoundsCounts[i]) index = self->animationBoundsCounts[i] - 1;
+	if (index < 0) index = 0;
+
+	box = self->animationBounds[i] + index * 4;
+	if (box[0] < bounds[0]) bounds[0] = box[0];
+	if (box[1] < bounds[1]) bounds[1] = box[1];
+	if (box[2] > bounds[2]) bounds[2] = box[2];
+	if (box[3] > bounds[3]) bounds[3] = box[3];
+	return 1;
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Spine Runtime Software License - Version 1.1
+ * 
+ * Copyright (c) 2013, Esoteric Software
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms in whole or in part, with
+ * or without modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ * 1. A Spine Essential, Professional, Enterprise, or Education License must
+ *    be purchased from Esoteric Software and the license must remain valid:
+ *    http://esotericsoftware.com/
+ * 2. Redistributions of source code must retain this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer.
+ * 3. Redistributions in binary form must reproduce this license, which is the
+ *    above copyright notice, this declaration of conditions and the following
+ *    disclaimer, in the documentation and/or other materials provided with the
+ *    distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonPose.h>
+#include <spine/Skeleton.h>
+#include <spine/extension.h>
+
+static const int BONE_CHANNELS = 5;
+static const int SLOT_CHANNELS = 4;
+
+spSkeletonPose* spSkeletonPose_create (int boneCount, int slotCount) {
+	spSkeletonPose* self = NEW(spSkeletonPose);
+	float* channels = CALLOC(float, boneCount * BONE_CHANNELS + slotCount * SLOT_CHANNELS);
+	CONST_CAST(int, self->boneCount) = boneCount;
+	CONST_CAST(float*, self->x) = channels;
+	CONST_CAST(float*, self->y) = self->x + boneCount;
+	CONST_CAST(float*, self->rotation) = self->y + boneCount;
+	CONST_CAST(float*, self->scaleX) = self->rotation + boneCount;
+	CONST_CAST(float*, self->scaleY) = self->scaleX + boneCount;
+	CONST_CAST(int, self->slotCount) = slotCount;
+	CONST_CAST(float*, self->r) = self->scaleY + boneCount;
+	CONST_CAST(float*, self->g) = self->r + slotCount;
+	CONST_CAST(float*, self->b) = self->g + slotCount;
+	CONST_CAST(float*, self->a) = self->b + slotCount;
+	return self;
+}
+
+void spSkeletonPose_dispose (spSkeletonPose* self) {
+	FREE(self->x); /* All channels share one block. */
+	FREE(self);
+}
+
+void spSkeletonPose_capture (spSkeletonPose* self, const spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < self->boneCount; ++i) {
+		const spBone* bone = skeleton->bones[i];
+		self->x[i] = bone->x;
+		self->y[i] = bone->y;
+		self->rotation[i] = bone->rotation;
+		self->scaleX[i] = bone->scaleX;
+		self->scaleY[i] = bone->scaleY;
+	}
+	for (i = 0; i < self->slotCount; ++i) {
+		const spSlot* slot = skeleton->slots[i];
+		self->r[i] = slot->r;
+		self->g[i] = slot->g;
+		self->b[i] = slot->b;
+		self->a[i] = slot->a;
+	}
+}
+
+void spSkeletonPose_restore (const spSkeletonPose* self, spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < self->boneCount; ++i) {
+		spBone* bone = skeleton->bones[i];
+		bone->x = self->x[i];
+		bone->y = self->y[i];
+		bone->rotation = self->rotation[i];
+		bone->scaleX = self->scaleX[i];
+		bone->scaleY = self->scaleY[i];
+	}
+	for (i = 0; i < self->slotCount; ++i) {
+		spSlot* slot = skeleton->slots[i];
+		slot->r = self->r[i];
+		slot->g = self->g[i];
+		slot->b = self->b[i];
+		slot->a = self->a[i];
+	}
+}
+
+void spSkeletonPose_copy (spSkeletonPose* self, const spSkeletonPose* pose) {
+	memcpy(self->x, pose->x, (self->boneCount * BONE_CHANNELS + self->slotCount * SLOT_CHANNELS) * sizeof(float));
+}
+
+int/*bool*/spSkeletonPose_matchesBones (const spSkeletonPose* self, const spSkeleton* skeleton) {
+	int i;
+	for (i = 0; i < self->boneCount; ++i) {
+		const spBone* bone = skeleton->bones[i];
+		if (self->x[i] != bone->x || self->y[i] != bone->y || self->rotation[i] != bone->rotation
+				|| self->scaleX[i] != bone->scaleX || self->scaleY[i] != bone->scaleY) return 0;
+	}
+	return 1;
+}
+
+static void _spSkeletonPose_lerp (float* values, const float* targets, int count, float alpha) {
+	int i;
+	for (i = 0; i < count; ++i)
+		values[i] += (targets[i] - values[i]) * alpha;
+}
+
+void spSkeletonPose_blend (spSkeletonPose* self, const spSkeletonPose* target, float alpha) {
+	int i;
+	_spSkeletonPose_lerp(self->x, target->x, self->boneCount * 2, alpha); /* x, y */
+	for (i = 0; i < self->boneCount; ++i) {
+		float amount = target->rotation[i] - self->rotation[i];
+		amount -= 360 * (float)floor((amount + 180) / 360); /* Branch free shortest path. */
+		self->rotation[i] += amount * alpha;
+	}
+	/* scaleX, scaleY, r, g, b, a */
+	_spSkeletonPose_lerp(self->scaleX, target->scaleX, self->boneCount * 2 + self->slotCount * SLOT_CHANNELS, alpha);
+}